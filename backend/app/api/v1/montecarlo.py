@@ -4,7 +4,17 @@ Este módulo expone los endpoints REST para crear, ejecutar y consultar
 experimentos Monte Carlo con múltiples réplicas.
 """
 
-from fastapi import APIRouter, BackgroundTasks, Depends, HTTPException, status
+from fastapi import (
+    APIRouter,
+    BackgroundTasks,
+    Depends,
+    HTTPException,
+    Query,
+    Response,
+    WebSocket,
+    WebSocketDisconnect,
+    status,
+)
 from sqlalchemy.orm import Session
 import pandas as pd
 
@@ -17,8 +27,16 @@ from app.schemas.montecarlo import (
     MonteCarloExperimentDetail,
     MonteCarloProgress,
 )
-from app.services.montecarlo_service import ejecutar_experimento_montecarlo
-from app.services.anova_service import calcular_anova_dos_vias, formatear_resultados_anova
+from app.services.montecarlo_service import (
+    ejecutar_experimento_montecarlo,
+    niveles_anova,
+)
+from app.services.anova_service import (
+    CellAggregates,
+    calcular_anova_desde_agregados,
+    calcular_anova_dos_vias,
+    formatear_resultados_anova,
+)
 
 router = APIRouter()
 
@@ -222,11 +240,21 @@ def get_experiment_progress(
             detail=f"Experimento {experiment_id} no encontrado",
         )
 
-    # Contar réplicas completadas
-    replicas_completadas = len([
-        r for r in experiment.replicas
-        if r.estado in ("completed", "failed")
-    ])
+    # Contar réplicas completadas: durante la ejecución se sirve desde el
+    # contador en memoria (sin tocar la base de datos); después, desde las
+    # réplicas persistidas
+    from app.services.montecarlo_service import get_progress_counter
+
+    counter = get_progress_counter(experiment_id)
+    if counter is not None:
+        replicas_completadas = counter[0]
+        progreso = int(counter[0] / counter[1] * 100) if counter[1] else 0
+    else:
+        replicas_completadas = len([
+            r for r in experiment.replicas
+            if r.estado in ("completed", "failed")
+        ])
+        progreso = experiment.progreso
 
     # Calcular tiempo transcurrido
     import datetime
@@ -244,7 +272,7 @@ def get_experiment_progress(
     return MonteCarloProgress(
         experiment_id=experiment.id,
         estado=experiment.estado,
-        progreso=experiment.progreso,
+        progreso=progreso,
         replicas_completadas=replicas_completadas,
         replicas_totales=experiment.num_replicas,
         tiempo_transcurrido_segundos=tiempo_transcurrido,
@@ -252,6 +280,25 @@ def get_experiment_progress(
     )
 
 
+@router.websocket("/experiments/{experiment_id}/ws")
+async def experiment_progress_ws(websocket: WebSocket, experiment_id: int):
+    """Canal de push de progreso y agregados incrementales.
+
+    El runner publica ticks {type: progress, ...} con réplicas completadas,
+    porcentaje y media/IC95 móviles de nivel_servicio_pct, y un mensaje
+    final {type: completed}. El cliente no necesita enviar nada; cualquier
+    texto recibido se ignora (keepalive).
+    """
+    from app.websocket import progress_manager
+
+    await progress_manager.connect(experiment_id, websocket)
+    try:
+        while True:
+            await websocket.receive_text()
+    except WebSocketDisconnect:
+        progress_manager.disconnect(experiment_id, websocket)
+
+
 @router.delete(
     "/experiments/{experiment_id}",
     status_code=status.HTTP_204_NO_CONTENT,
@@ -319,7 +366,10 @@ def delete_experiment(
     - Medias por configuración con intervalos de confianza
 
     Requiere que el experimento esté completado y tenga al menos 2 niveles
-    de cada factor para poder calcular el ANOVA.
+    de cada factor para poder calcular el ANOVA. Un experimento individual
+    tiene una sola configuración (un nivel por factor); para el análisis
+    entre configuraciones use el endpoint /anova de campaña, que fusiona
+    los agregados materializados de varios experimentos.
     """,
 )
 def get_experiment_anova(
@@ -434,40 +484,337 @@ def get_experiment_anova(
         )
 
 
+@router.get(
+    "/anova",
+    summary="ANOVA de dos vías sobre una campaña de experimentos",
+    description="""
+    Calcula el ANOVA de dos vías (capacidad × duración) combinando varios
+    experimentos Monte Carlo, cada uno con una configuración distinta.
+
+    El cálculo fusiona los estadísticos suficientes por celda
+    (`anova_agregados`: n, suma, suma de cuadrados del nivel de servicio)
+    materializados durante cada corrida, así que es de tamaño constante
+    sin recorrer las tablas de réplicas. Para experimentos anteriores a la
+    materialización, los agregados de su celda se reconstruyen con una
+    consulta SQL agrupada.
+
+    Requiere al menos 2 niveles de cada factor entre los experimentos.
+    """,
+)
+def get_campaign_anova(
+    *,
+    db: Session = Depends(get_db),
+    ids: str,
+):
+    """Calcula ANOVA de dos vías fusionando agregados de varios experimentos.
+
+    Args:
+        db: Sesión de base de datos
+        ids: IDs de experimentos separados por comas
+
+    Returns:
+        Resultados completos del análisis ANOVA
+
+    Raises:
+        HTTPException: Si algún experimento no existe o no está completado,
+            o la campaña no cubre 2 niveles de cada factor
+    """
+    from sqlalchemy import func, select
+
+    from app.models.montecarlo import MonteCarloReplica
+
+    try:
+        experiment_ids = [int(part) for part in ids.split(",") if part.strip()]
+    except ValueError:
+        raise HTTPException(
+            status_code=status.HTTP_400_BAD_REQUEST,
+            detail=f"Lista de IDs inválida: {ids}",
+        )
+
+    if len(experiment_ids) < 2:
+        raise HTTPException(
+            status_code=status.HTTP_400_BAD_REQUEST,
+            detail="Se requieren al menos 2 experimentos para el ANOVA de campaña",
+        )
+
+    agregados = CellAggregates()
+    for exp_id in experiment_ids:
+        experiment = _get_completed_experiment(db, exp_id)
+
+        if experiment.anova_agregados:
+            agregados.merge(CellAggregates.from_dict(experiment.anova_agregados))
+            continue
+
+        # Experimento anterior a la materialización: reconstruir los
+        # agregados de su celda con una consulta agrupada, sin traer filas
+        col = MonteCarloReplica.nivel_servicio_pct
+        n, total, sumsq = db.execute(
+            select(func.count(col), func.sum(col), func.sum(col * col)).where(
+                MonteCarloReplica.experiment_id == exp_id,
+                MonteCarloReplica.estado == "completed",
+                col.isnot(None),
+            )
+        ).one()
+        if not n:
+            raise HTTPException(
+                status_code=status.HTTP_400_BAD_REQUEST,
+                detail=f"El experimento {exp_id} no tiene réplicas completadas",
+            )
+        celda = CellAggregates()
+        cap_nivel, dur_nivel = niveles_anova(experiment.configuracion.parametros)
+        celda.cells[(cap_nivel, dur_nivel)] = [int(n), float(total), float(sumsq)]
+        agregados.merge(celda)
+
+    niveles_cap, niveles_dur = agregados.levels()
+    if len(niveles_cap) < 2:
+        raise HTTPException(
+            status_code=status.HTTP_400_BAD_REQUEST,
+            detail=f"Se necesitan al menos 2 niveles del factor Capacidad para ANOVA. La campaña solo cubre: {', '.join(niveles_cap)}.",
+        )
+    if len(niveles_dur) < 2:
+        raise HTTPException(
+            status_code=status.HTTP_400_BAD_REQUEST,
+            detail=f"Se necesitan al menos 2 niveles del factor Duración para ANOVA. La campaña solo cubre: {', '.join(niveles_dur)}.",
+        )
+
+    try:
+        resultado = calcular_anova_desde_agregados(agregados)
+        return formatear_resultados_anova(resultado)
+    except Exception as e:
+        raise HTTPException(
+            status_code=status.HTTP_500_INTERNAL_SERVER_ERROR,
+            detail=f"Error al calcular ANOVA: {str(e)}. Tipo: {type(e).__name__}",
+        )
+
+
+# Columnas de réplica proyectables vía fields= (y métricas del histograma)
+_REPLICA_FIELD_NAMES = [
+    "nivel_servicio_pct",
+    "dias_con_quiebre",
+    "inventario_promedio_tm",
+    "autonomia_promedio_dias",
+    "probabilidad_quiebre_stock_pct",
+    "demanda_insatisfecha_tm",
+    "disrupciones_totales",
+]
+
+
+def _get_completed_experiment(db: Session, experiment_id: int) -> MonteCarloExperiment:
+    experiment = db.query(MonteCarloExperiment).filter(
+        MonteCarloExperiment.id == experiment_id
+    ).first()
+
+    if not experiment:
+        raise HTTPException(
+            status_code=status.HTTP_404_NOT_FOUND,
+            detail=f"Experimento {experiment_id} no encontrado",
+        )
+
+    if experiment.estado != "completed":
+        raise HTTPException(
+            status_code=status.HTTP_400_BAD_REQUEST,
+            detail=f"El experimento debe estar completado. Estado actual: {experiment.estado}",
+        )
+
+    return experiment
+
+
 @router.get(
     "/experiments/{experiment_id}/replicas",
     summary="Obtener réplicas de un experimento",
     description="""
-    Devuelve todas las réplicas completadas de un experimento Monte Carlo
+    Devuelve las réplicas completadas de un experimento Monte Carlo
     en formato simplificado para visualizaciones.
 
-    Los datos incluyen métricas clave de cada réplica:
-    - Nivel de servicio
-    - Días con quiebre
-    - Inventario promedio
-    - Autonomía promedio
-    - Probabilidad de quiebre de stock
+    Sin `limit` devuelve la colección completa (comportamiento original,
+    del que dependen las vistas de distribución). Pasar `limit` activa la
+    paginación por cursor (`cursor` = último replica_id recibido, `limit`
+    = tamaño de página); `fields=` (lista separada por comas) proyecta
+    columnas, de modo que las vistas que solo necesitan una métrica no
+    materialicen la colección completa.
 
-    Útil para generar histogramas, boxplots, y otros gráficos de distribución.
+    Útil para generar histogramas, boxplots, y otros gráficos de distribución;
+    para histogramas prefiera el endpoint /histogram que no envía réplicas
+    crudas.
     """,
 )
 def get_experiment_replicas(
     *,
     db: Session = Depends(get_db),
     experiment_id: int,
+    cursor: int | None = None,
+    limit: int | None = Query(None, ge=1, le=10000),
+    fields: str | None = None,
 ):
     """Obtener réplicas de un experimento para visualizaciones.
 
     Args:
         db: Sesión de base de datos
         experiment_id: ID del experimento
+        cursor: Último replica_id de la página anterior (paginación)
+        limit: Tamaño de página; sin especificar, sin paginar
+        fields: Columnas a incluir, separadas por comas (default: todas)
+
+    Returns:
+        Página de réplicas con las métricas solicitadas y next_cursor
+
+    Raises:
+        HTTPException: Si el experimento no existe, no está completado o
+            se solicita un campo desconocido
+    """
+    from sqlalchemy import select
+
+    from app.models.montecarlo import MonteCarloReplica
+
+    experiment = _get_completed_experiment(db, experiment_id)
+
+    if fields:
+        field_names = [f.strip() for f in fields.split(",") if f.strip()]
+        unknown = [f for f in field_names if f not in _REPLICA_FIELD_NAMES]
+        if unknown:
+            raise HTTPException(
+                status_code=status.HTTP_400_BAD_REQUEST,
+                detail=f"Campos desconocidos: {', '.join(unknown)}",
+            )
+    else:
+        field_names = list(_REPLICA_FIELD_NAMES)
+
+    # Proyección de columnas sin objetos ORM, paginada por id
+    columns = [getattr(MonteCarloReplica, name) for name in field_names]
+    stmt = (
+        select(MonteCarloReplica.id, *columns)
+        .where(
+            MonteCarloReplica.experiment_id == experiment_id,
+            MonteCarloReplica.estado == "completed",
+        )
+        .order_by(MonteCarloReplica.id)
+    )
+    if limit is not None:
+        stmt = stmt.limit(limit)
+    if cursor is not None:
+        stmt = stmt.where(MonteCarloReplica.id > cursor)
+
+    rows = db.execute(stmt).all()
+
+    datos = [
+        {
+            "replica_id": row[0],
+            **{name: value if value is not None else 0 for name, value in zip(field_names, row[1:])},
+        }
+        for row in rows
+    ]
+    next_cursor = rows[-1][0] if limit is not None and len(rows) == limit else None
+
+    return {
+        "experiment_id": experiment_id,
+        "experiment_nombre": experiment.nombre,
+        "num_replicas": len(datos),
+        "next_cursor": next_cursor,
+        "replicas": datos
+    }
+
+
+@router.get(
+    "/experiments/{experiment_id}/histogram",
+    summary="Histograma pre-calculado de una métrica",
+    description="""
+    Calcula el histograma de una métrica de réplica en el servidor.
+
+    Las visualizaciones de distribución (MonteCarloDistributions) pueden
+    consumir los bins directamente sin descargar las réplicas crudas.
+    """,
+)
+def get_experiment_histogram(
+    *,
+    db: Session = Depends(get_db),
+    experiment_id: int,
+    metric: str = "nivel_servicio_pct",
+    bins: int = 50,
+):
+    """Obtener el histograma pre-calculado de una métrica de réplica.
+
+    Args:
+        db: Sesión de base de datos
+        experiment_id: ID del experimento
+        metric: Métrica de réplica a binnear
+        bins: Número de bins
 
     Returns:
-        Lista de réplicas con métricas clave
+        Bordes de bins y conteos, junto al total de réplicas consideradas
+
+    Raises:
+        HTTPException: Si el experimento no existe, no está completado o
+            la métrica es desconocida
+    """
+    import numpy as np
+    from sqlalchemy import select
+
+    from app.models.montecarlo import MonteCarloReplica
+
+    experiment = _get_completed_experiment(db, experiment_id)
+
+    if metric not in _REPLICA_FIELD_NAMES:
+        raise HTTPException(
+            status_code=status.HTTP_400_BAD_REQUEST,
+            detail=f"Métrica desconocida: {metric}",
+        )
+
+    column = getattr(MonteCarloReplica, metric)
+    stmt = select(column).where(
+        MonteCarloReplica.experiment_id == experiment_id,
+        MonteCarloReplica.estado == "completed",
+        column.isnot(None),
+    )
+    values = np.array([row[0] for row in db.execute(stmt)])
+
+    if len(values) == 0:
+        counts, edges = np.array([]), np.array([])
+    else:
+        counts, edges = np.histogram(values, bins=bins)
+
+    return {
+        "experiment_id": experiment_id,
+        "experiment_nombre": experiment.nombre,
+        "metric": metric,
+        "num_replicas": int(len(values)),
+        "bin_edges": [float(e) for e in edges],
+        "counts": [int(c) for c in counts],
+    }
+
+
+@router.get(
+    "/experiments/{experiment_id}/replicas.arrow",
+    summary="Obtener réplicas como Arrow IPC",
+    description="""
+    Devuelve la tabla de KPIs por réplica como Arrow IPC (columnas tipadas).
+
+    Para experimentos grandes (100k réplicas) la transferencia es de pocos MB
+    de columnas binarias en lugar de decenas de MB de JSON que el navegador
+    luego debe re-parsear. El frontend puede leerla directamente con
+    apache-arrow sin copias intermedias.
+    """,
+)
+def get_experiment_replicas_arrow(
+    *,
+    db: Session = Depends(get_db),
+    experiment_id: int,
+) -> Response:
+    """Obtener réplicas de un experimento en formato Arrow IPC.
+
+    Args:
+        db: Sesión de base de datos
+        experiment_id: ID del experimento
+
+    Returns:
+        Respuesta binaria con la tabla Arrow IPC
 
     Raises:
         HTTPException: Si el experimento no existe o no está completado
     """
+    from sqlalchemy import select
+
+    from dal.export import arrow_ipc_bytes
+
     from app.models.montecarlo import MonteCarloReplica
 
     experiment = db.query(MonteCarloExperiment).filter(
@@ -486,32 +833,34 @@ def get_experiment_replicas(
             detail=f"El experimento debe estar completado. Estado actual: {experiment.estado}",
         )
 
-    # Obtener réplicas completadas
-    replicas = db.query(MonteCarloReplica).filter(
-        MonteCarloReplica.experiment_id == experiment_id,
-        MonteCarloReplica.estado == "completed"
-    ).all()
-
-    # Formatear datos
-    datos = []
-    for replica in replicas:
-        datos.append({
-            "replica_id": replica.id,
-            "nivel_servicio_pct": replica.nivel_servicio_pct,
-            "dias_con_quiebre": replica.dias_con_quiebre or 0,
-            "inventario_promedio_tm": replica.inventario_promedio_tm or 0,
-            "autonomia_promedio_dias": replica.autonomia_promedio_dias or 0,
-            "probabilidad_quiebre_stock_pct": replica.probabilidad_quiebre_stock_pct or 0,
-            "demanda_insatisfecha_tm": replica.demanda_insatisfecha_tm or 0,
-            "disrupciones_totales": replica.disrupciones_totales or 0,
-        })
+    # Proyección de columnas sin materializar objetos ORM
+    columns = [
+        MonteCarloReplica.id.label("replica_id"),
+        MonteCarloReplica.replica_numero,
+        MonteCarloReplica.nivel_servicio_pct,
+        MonteCarloReplica.probabilidad_quiebre_stock_pct,
+        MonteCarloReplica.dias_con_quiebre,
+        MonteCarloReplica.inventario_promedio_tm,
+        MonteCarloReplica.inventario_minimo_tm,
+        MonteCarloReplica.autonomia_promedio_dias,
+        MonteCarloReplica.demanda_insatisfecha_tm,
+        MonteCarloReplica.disrupciones_totales,
+    ]
+    stmt = (
+        select(*columns)
+        .where(
+            MonteCarloReplica.experiment_id == experiment_id,
+            MonteCarloReplica.estado == "completed",
+        )
+        .order_by(MonteCarloReplica.replica_numero)
+    )
+    rows = db.execute(stmt).all()
+    df = pd.DataFrame(rows, columns=[c.key for c in columns])
 
-    return {
-        "experiment_id": experiment_id,
-        "experiment_nombre": experiment.nombre,
-        "num_replicas": len(datos),
-        "replicas": datos
-    }
+    return Response(
+        content=arrow_ipc_bytes(df),
+        media_type="application/vnd.apache.arrow.file",
+    )
 
 
 @router.get(
@@ -657,3 +1006,186 @@ def get_experiment_series_temporales(
         "dias_simulados": sim_days,
         "series_temporales": series_agregadas,
     }
+
+
+@router.get(
+    "/compare",
+    summary="Comparar experimentos Monte Carlo",
+    description="""
+    Compara varios experimentos completados y devuelve solo la tabla
+    agregada alineada: por KPI, medias e intervalos de confianza t por
+    experimento, deltas apareados contra el primer experimento (baseline)
+    con marcador de significancia (test de Welch), y un histograma de la
+    métrica elegida con bins compartidos entre experimentos.
+
+    Todo se calcula en el servidor desde los `resultados_agregados`
+    almacenados más una pasada SQL agrupada sobre las réplicas, así que
+    la respuesta es O(número de KPIs) sin importar cuántas réplicas
+    tenga cada experimento.
+    """,
+)
+def compare_experiments(
+    *,
+    db: Session = Depends(get_db),
+    ids: str,
+    metric: str = "nivel_servicio_pct",
+    bins: int = 40,
+    alpha: float = 0.05,
+):
+    """Comparar experimentos con agregados calculados en el servidor.
+
+    Args:
+        db: Sesión de base de datos
+        ids: IDs de experimentos separados por comas; el primero es el baseline
+        metric: Métrica de réplica para el histograma de ejes compartidos
+        bins: Número de bins del histograma
+        alpha: Nivel de significancia para los intervalos de confianza
+
+    Returns:
+        Tabla alineada por KPI (medias, IC, deltas vs. baseline) e
+        histogramas con bordes de bins compartidos
+
+    Raises:
+        HTTPException: Si algún experimento no existe o no está completado,
+            la lista de IDs es inválida o la métrica es desconocida
+    """
+    from sqlalchemy import Integer, cast, func, select
+
+    from bll.statistics import confidence_interval_from_stats, welch_test_from_stats
+
+    from app.models.montecarlo import MonteCarloReplica
+
+    try:
+        experiment_ids = [int(part) for part in ids.split(",") if part.strip()]
+    except ValueError:
+        raise HTTPException(
+            status_code=status.HTTP_400_BAD_REQUEST,
+            detail=f"Lista de IDs inválida: {ids}",
+        )
+
+    if len(experiment_ids) < 2:
+        raise HTTPException(
+            status_code=status.HTTP_400_BAD_REQUEST,
+            detail="Se requieren al menos 2 experimentos para comparar",
+        )
+
+    if metric not in _REPLICA_FIELD_NAMES:
+        raise HTTPException(
+            status_code=status.HTTP_400_BAD_REQUEST,
+            detail=f"Métrica desconocida: {metric}",
+        )
+
+    experiments = {
+        exp_id: _get_completed_experiment(db, exp_id) for exp_id in experiment_ids
+    }
+
+    # Una sola pasada agrupada: (n, suma, suma², min, max) de cada KPI
+    # por experimento, sin materializar las réplicas
+    aggregates = []
+    for name in _REPLICA_FIELD_NAMES:
+        column = getattr(MonteCarloReplica, name)
+        aggregates.extend([
+            func.count(column),
+            func.sum(column),
+            func.sum(column * column),
+            func.min(column),
+            func.max(column),
+        ])
+
+    stmt = (
+        select(MonteCarloReplica.experiment_id, *aggregates)
+        .where(
+            MonteCarloReplica.experiment_id.in_(experiment_ids),
+            MonteCarloReplica.estado == "completed",
+        )
+        .group_by(MonteCarloReplica.experiment_id)
+    )
+    stats_por_experimento: dict[int, dict[str, dict]] = {}
+    for row in db.execute(stmt):
+        exp_id, values = row[0], row[1:]
+        per_metric = {}
+        for i, name in enumerate(_REPLICA_FIELD_NAMES):
+            n, total, sumsq, vmin, vmax = values[i * 5:(i + 1) * 5]
+            entry = confidence_interval_from_stats(
+                int(n or 0), float(total or 0.0), float(sumsq or 0.0), alpha
+            )
+            entry["min"] = round(float(vmin), 4) if vmin is not None else None
+            entry["max"] = round(float(vmax), 4) if vmax is not None else None
+            per_metric[name] = entry
+        stats_por_experimento[exp_id] = per_metric
+
+    missing = [exp_id for exp_id in experiment_ids if exp_id not in stats_por_experimento]
+    if missing:
+        raise HTTPException(
+            status_code=status.HTTP_400_BAD_REQUEST,
+            detail=f"Experimentos sin réplicas completadas: {missing}",
+        )
+
+    # Tabla alineada por KPI con deltas apareados contra el baseline
+    baseline_id = experiment_ids[0]
+    kpis = []
+    for name in _REPLICA_FIELD_NAMES:
+        base = stats_por_experimento[baseline_id][name]
+        por_experimento = []
+        for exp_id in experiment_ids:
+            entry = dict(stats_por_experimento[exp_id][name])
+            entry["experiment_id"] = exp_id
+            if exp_id != baseline_id:
+                _, p_value = welch_test_from_stats(
+                    entry["n"], entry["mean"], entry["std"] ** 2,
+                    base["n"], base["mean"], base["std"] ** 2,
+                )
+                entry["delta_vs_baseline"] = round(entry["mean"] - base["mean"], 4)
+                entry["p_valor"] = round(p_value, 6)
+                entry["significancia"] = (
+                    "***" if p_value < 0.001 else
+                    "**" if p_value < 0.01 else
+                    "*" if p_value < 0.05 else
+                    "ns"
+                )
+            por_experimento.append(entry)
+        kpis.append({"metric": name, "experimentos": por_experimento})
+
+    # Histograma de la métrica elegida con bordes compartidos, binneado en SQL
+    lows = [stats_por_experimento[e][metric]["min"] for e in experiment_ids]
+    highs = [stats_por_experimento[e][metric]["max"] for e in experiment_ids]
+    lo = min(v for v in lows if v is not None) if any(v is not None for v in lows) else 0.0
+    hi = max(v for v in highs if v is not None) if any(v is not None for v in highs) else 0.0
+
+    histogramas: dict[int, list[int]] = {e: [0] * bins for e in experiment_ids}
+    if hi > lo:
+        width = (hi - lo) / bins
+        column = getattr(MonteCarloReplica, metric)
+        bucket = cast((column - lo) / width, Integer)
+        hist_stmt = (
+            select(MonteCarloReplica.experiment_id, bucket, func.count())
+            .where(
+                MonteCarloReplica.experiment_id.in_(experiment_ids),
+                MonteCarloReplica.estado == "completed",
+                column.isnot(None),
+            )
+            .group_by(MonteCarloReplica.experiment_id, bucket)
+        )
+        for exp_id, idx, count in db.execute(hist_stmt):
+            histogramas[exp_id][min(max(int(idx), 0), bins - 1)] += int(count)
+
+    bin_edges = [lo + (hi - lo) * i / bins for i in range(bins + 1)] if hi > lo else []
+
+    return {
+        "baseline_id": baseline_id,
+        "experimentos": [
+            {
+                "experiment_id": exp_id,
+                "nombre": experiments[exp_id].nombre,
+                "num_replicas": experiments[exp_id].num_replicas,
+                "resultados_agregados": experiments[exp_id].resultados_agregados,
+            }
+            for exp_id in experiment_ids
+        ],
+        "kpis": kpis,
+        "histograma": {
+            "metric": metric,
+            "bin_edges": bin_edges,
+            "counts": {str(e): histogramas[e] for e in experiment_ids},
+        },
+    }
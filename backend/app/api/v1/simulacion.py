@@ -15,10 +15,17 @@ router = APIRouter()
 async def execute_simulation(
     request: SimulacionRequest,
     db: Session = Depends(get_db),
+    force: bool = False,
 ):
-    """Ejecutar simulación única."""
+    """Ejecutar simulación única.
+
+    Con force=true se ignora el cache por hash de configuración y se
+    re-ejecuta aunque exista un resultado idéntico.
+    """
     try:
-        simulacion = await simulacion_service.execute_simulation(db, request.configuracion_id)
+        simulacion = await simulacion_service.execute_simulation(
+            db, request.configuracion_id, use_cache=not force
+        )
         return simulacion
     except ValueError as e:
         raise HTTPException(
@@ -102,9 +109,23 @@ def get_resultados(
 @router.get("/{simulacion_id}/series-temporales", response_model=dict)
 async def get_series_temporales(
     simulacion_id: int,
+    start: int = 0,
+    end: int | None = None,
+    bucket_days: int = 1,
+    width_px: int | None = None,
     db: Session = Depends(get_db),
 ):
-    """Obtener series temporales de una simulación (re-ejecuta con la misma semilla)."""
+    """Obtener series temporales de una simulación, por ventana y resolución.
+
+    La serie diaria vive en un store en disco por simulación (la primera
+    consulta la genera re-ejecutando con la misma semilla); start/end acotan
+    la ventana de días. Con width_px (ancho del gráfico en píxeles) el
+    servidor elige la resolución precomputada más fina — diaria, semanal o
+    mensual — cuya serie cabe en esos puntos y responde envolventes
+    min/mean/max por bucket, así el payload queda acotado a unos pocos KB
+    sin importar el horizonte; bucket_days > 1 fuerza una resolución
+    explícita.
+    """
     sim = simulacion_service.get_simulacion(db, simulacion_id)
     if not sim:
         raise HTTPException(
@@ -118,24 +139,33 @@ async def get_series_temporales(
             detail=f"Simulación en estado '{sim.estado}', no hay datos disponibles",
         )
 
-    # Re-ejecutar simulación para obtener series temporales
+    if bucket_days < 1:
+        raise HTTPException(
+            status_code=status.HTTP_400_BAD_REQUEST,
+            detail="bucket_days debe ser >= 1",
+        )
+
+    if width_px is not None and width_px < 1:
+        raise HTTPException(
+            status_code=status.HTTP_400_BAD_REQUEST,
+            detail="width_px debe ser >= 1",
+        )
+
     try:
-        from app.models.configuracion import Configuracion
-        config_db = db.query(Configuracion).filter(Configuracion.id == sim.configuracion_id).first()
-        if not config_db:
-            raise HTTPException(
-                status_code=status.HTTP_404_NOT_FOUND,
-                detail="Configuración no encontrada",
-            )
-
-        # Re-ejecutar con los mismos parámetros
-        resultado = await simulacion_service.ejecutar_modelo(config_db.parametros)
-
-        # Retornar solo las series temporales
+        bucket_efectivo, series = await simulacion_service.obtener_series_temporales(
+            db, sim, start=start, end=end, bucket_days=bucket_days, width_px=width_px
+        )
         return {
             "simulacion_id": simulacion_id,
-            "series_temporales": resultado.get("series_temporales", [])
+            "start": start,
+            "bucket_days": bucket_efectivo,
+            "series_temporales": series,
         }
+    except ValueError as e:
+        raise HTTPException(
+            status_code=status.HTTP_404_NOT_FOUND,
+            detail=str(e),
+        )
     except Exception as e:
         raise HTTPException(
             status_code=status.HTTP_500_INTERNAL_SERVER_ERROR,
@@ -25,6 +25,9 @@ class Settings(BaseSettings):
     max_workers: int = 11
     default_replicas: int = 1000
 
+    # Series temporales en disco (chunks memory-mapped por simulación)
+    metrics_store_dir: str = "./metrics_store"
+
     model_config = SettingsConfigDict(
         env_file=".env",
         env_file_encoding="utf-8",
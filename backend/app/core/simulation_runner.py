@@ -12,14 +12,13 @@ from bll.config import SimulationConfig
 from bll.simulation import run_simulation
 
 
-async def run_simulation_async(params: dict[str, Any]) -> dict[str, Any]:
-    loop = asyncio.get_event_loop()
-
+def build_simulation_config(params: dict[str, Any]) -> SimulationConfig:
+    """Resuelve los parámetros de una Configuracion en un SimulationConfig."""
     inv_initial = params.get("inventario_inicial_tm")
     if inv_initial is None:
         inv_initial = params["capacidad_hub_tm"] * params.get("inventario_inicial_pct", 60) / 100
 
-    config = SimulationConfig(
+    return SimulationConfig(
         capacity_tm=params["capacidad_hub_tm"],
         reorder_point_tm=params["punto_reorden_tm"],
         order_quantity_tm=params["cantidad_pedido_tm"],
@@ -38,6 +37,11 @@ async def run_simulation_async(params: dict[str, Any]) -> dict[str, Any]:
         use_seasonality=params["usar_estacionalidad"],
     )
 
+
+async def run_simulation_async(params: dict[str, Any]) -> dict[str, Any]:
+    loop = asyncio.get_event_loop()
+    config = build_simulation_config(params)
+
     start = time.time()
     result = await loop.run_in_executor(None, run_simulation, config)
     duration = time.time() - start
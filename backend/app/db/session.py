@@ -1,6 +1,6 @@
 """Database session management."""
 
-from sqlalchemy import create_engine
+from sqlalchemy import create_engine, event
 from sqlalchemy.orm import sessionmaker
 
 from app.config import get_settings
@@ -13,6 +13,23 @@ engine = create_engine(
     echo=settings.debug,
 )
 
+if "sqlite" in settings.database_url:
+    @event.listens_for(engine, "connect")
+    def _set_sqlite_pragmas(dbapi_connection, connection_record):
+        """Modo WAL en cada conexión SQLite.
+
+        Con el journal por defecto (rollback), los commits de un experimento
+        bloquean las lecturas de la API sobre el mismo archivo. WAL permite
+        lectores concurrentes con un único escritor, y busy_timeout hace que
+        un escritor en espera reintente en lugar de fallar con
+        "database is locked".
+        """
+        cursor = dbapi_connection.cursor()
+        cursor.execute("PRAGMA journal_mode=WAL")
+        cursor.execute("PRAGMA synchronous=NORMAL")
+        cursor.execute("PRAGMA busy_timeout=10000")
+        cursor.close()
+
 SessionLocal = sessionmaker(autocommit=False, autoflush=False, bind=engine)
 
 
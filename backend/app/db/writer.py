@@ -0,0 +1,140 @@
+"""Escritor dedicado de base de datos (write-behind).
+
+Durante un experimento, los commits del runner compiten con las lecturas
+de la API por el mismo archivo SQLite. Este módulo desacopla ambos: las
+escrituras del experimento se encolan hacia un único hilo escritor que
+las agrupa en lotes y hace un commit por lote, mientras las lecturas
+siguen pasando por las sesiones normales. Con un solo escritor tampoco
+pueden competir dos experimentos concurrentes entre sí por el write lock.
+
+El hilo mantiene una sesión de larga vida, así que la caché de sentencias
+compiladas de la conexión se reutiliza entre lotes (las inserciones
+masivas ejecutan como executemany sobre la sentencia preparada).
+"""
+
+import queue
+import threading
+from concurrent.futures import Future
+from typing import Callable
+
+from sqlalchemy.orm import Session
+
+# Máximo de operaciones agrupadas en un commit
+_MAX_BATCH_OPS = 64
+
+_writer: "DatabaseWriter | None" = None
+_writer_lock = threading.Lock()
+
+
+class DatabaseWriter:
+    """Hilo único que aplica operaciones de escritura encoladas por lotes."""
+
+    def __init__(self):
+        self._queue: queue.Queue = queue.Queue()
+        # Errores de operaciones cuyos futures nadie lee (fire-and-forget);
+        # flush() relanza el primero acumulado desde el último flush
+        self._errors: list[Exception] = []
+        self._errors_lock = threading.Lock()
+        self._thread = threading.Thread(
+            target=self._run, name="db-writer", daemon=True
+        )
+        self._thread.start()
+
+    def submit(self, work: Callable[[Session], None]) -> Future:
+        """Encola una operación de escritura.
+
+        Args:
+            work: Callable que recibe la sesión del escritor; sus cambios
+                se commitean junto con el resto del lote
+
+        Returns:
+            Future resuelto cuando la operación quedó commiteada
+        """
+        future: Future = Future()
+        self._queue.put((work, future))
+        return future
+
+    def flush(self, timeout: float | None = None) -> None:
+        """Bloquea hasta que todo lo encolado hasta ahora esté commiteado.
+
+        Si alguna operación encolada desde el último flush falló, relanza
+        su excepción: las escrituras fire-and-forget no se pierden en
+        silencio, el que encoló se entera a más tardar aquí.
+        """
+        self.submit(lambda session: None).result(timeout)
+        with self._errors_lock:
+            if self._errors:
+                first = self._errors[0]
+                self._errors.clear()
+                raise first
+
+    def shutdown(self) -> None:
+        """Drena la cola y detiene el hilo escritor."""
+        self._queue.put(None)
+        self._thread.join()
+
+    def _run(self) -> None:
+        from app.db.session import SessionLocal
+
+        session = SessionLocal()
+        try:
+            while True:
+                item = self._queue.get()
+                if item is None:
+                    break
+
+                # Drenar lo pendiente para commitear en un solo lote
+                batch = [item]
+                while len(batch) < _MAX_BATCH_OPS:
+                    try:
+                        extra = self._queue.get_nowait()
+                    except queue.Empty:
+                        break
+                    if extra is None:
+                        self._queue.put(None)
+                        break
+                    batch.append(extra)
+
+                try:
+                    for work, _ in batch:
+                        work(session)
+                    session.commit()
+                except Exception:
+                    session.rollback()
+                    # Reintentar de a una para que una operación mala
+                    # solo falle su propio future
+                    for work, future in batch:
+                        try:
+                            work(session)
+                            session.commit()
+                        except Exception as exc:
+                            session.rollback()
+                            with self._errors_lock:
+                                self._errors.append(exc)
+                            future.set_exception(exc)
+                        else:
+                            future.set_result(None)
+                    continue
+
+                for _, future in batch:
+                    future.set_result(None)
+        finally:
+            session.close()
+
+
+def get_writer() -> DatabaseWriter:
+    """Obtiene el escritor dedicado del proceso (lo crea si no existe)."""
+    global _writer
+    with _writer_lock:
+        if _writer is None:
+            _writer = DatabaseWriter()
+        return _writer
+
+
+def shutdown_writer() -> None:
+    """Detiene el escritor dedicado si está activo."""
+    global _writer
+    with _writer_lock:
+        if _writer is not None:
+            _writer.shutdown()
+            _writer = None
@@ -19,7 +19,8 @@ async def lifespan(app: FastAPI):
     init_db()
     yield
     # Shutdown
-    pass
+    from bll.worker_pool import shutdown_worker_pool
+    shutdown_worker_pool(wait=False)
 
 
 app = FastAPI(
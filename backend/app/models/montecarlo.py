@@ -74,6 +74,11 @@ class MonteCarloExperiment(Base):
     # Incluye: mean, std, min, max, p25, p50, p75, p95 para cada KPI
     resultados_agregados: Mapped[dict | None] = mapped_column(JSON, nullable=True)
 
+    # Estadísticos suficientes para ANOVA por celda capacidad × duración
+    # (n, suma, suma de cuadrados), mantenidos durante la corrida: el
+    # análisis se deriva de este JSON sin recorrer las réplicas
+    anova_agregados: Mapped[dict | None] = mapped_column(JSON, nullable=True)
+
     # Error handling
     error_mensaje: Mapped[str | None] = mapped_column(Text, nullable=True)
 
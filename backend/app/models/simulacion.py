@@ -34,6 +34,13 @@ class Simulacion(Base):
         index=True,
     )  # running, completed, failed
 
+    # Hash canónico del SimulationConfig resuelto (cache por contenido)
+    config_hash: Mapped[str | None] = mapped_column(
+        String(64),
+        nullable=True,
+        index=True,
+    )
+
     # Resultados (21 KPIs)
     nivel_servicio_pct: Mapped[float | None] = mapped_column(Float)
     probabilidad_quiebre_stock_pct: Mapped[float | None] = mapped_column(Float)
@@ -7,7 +7,9 @@ Este módulo implementa:
 - Tamaño del efecto (eta cuadrado)
 """
 
+import sys
 from dataclasses import dataclass
+from pathlib import Path
 from typing import Dict, List, Optional
 
 import numpy as np
@@ -17,6 +19,12 @@ from statsmodels.formula.api import ols
 from statsmodels.stats.anova import anova_lm
 from statsmodels.stats.multicomp import pairwise_tukeyhsd
 
+_root = Path(__file__).parents[3]
+if str(_root) not in sys.path:
+    sys.path.insert(0, str(_root))
+
+from bll.statistics import CellAggregates, anova_from_aggregates
+
 
 @dataclass
 class ANOVAResult:
@@ -176,6 +184,59 @@ def calcular_anova_dos_vias(
     )
 
 
+def calcular_anova_desde_agregados(agregados: CellAggregates) -> ANOVAResult:
+    """ANOVA de dos vías desde los estadísticos suficientes por celda.
+
+    Los agregados (n, suma, suma de cuadrados por combinación
+    capacidad × duración) se mantienen incrementalmente a medida que
+    completan las réplicas y se materializan con el experimento, así que
+    este cálculo es de tamaño constante sin importar cuántas réplicas
+    haya — no se recorre la tabla de réplicas ni se re-ajusta el OLS.
+    """
+    resultado = anova_from_aggregates(agregados, factor1="capacidad", factor2="duracion")
+
+    tabla = resultado.table.copy()
+    tabla.index = [
+        'Capacidad' if idx == 'C(capacidad)' else
+        'Duración' if idx == 'C(duracion)' else
+        'Capacidad × Duración' if ':' in idx else
+        'Residual'
+        for idx in tabla.index
+    ]
+    tabla.columns = ['SC', 'gl', 'MC', 'F', 'p-valor']
+
+    # Medias por configuración con IC al 95% desde los mismos agregados
+    medias = []
+    for (cap, dur), (n, s, ss) in sorted(agregados.cells.items()):
+        mean = s / n
+        var = max(0.0, (ss - s * s / n) / (n - 1)) if n > 1 else 0.0
+        std = np.sqrt(var)
+        margin = 1.96 * std / np.sqrt(n) if n > 0 else 0.0
+        medias.append({
+            "capacidad": cap,
+            "duracion": dur,
+            "mean": mean,
+            "std": std,
+            "count": n,
+            "ci_lower": mean - margin,
+            "ci_upper": mean + margin,
+        })
+
+    return ANOVAResult(
+        tabla_anova=tabla,
+        efecto_capacidad=resultado.main_effects["capacidad"],
+        efecto_duracion=resultado.main_effects["duracion"],
+        efecto_interaccion=resultado.interaction_effect,
+        eta_cuadrado_capacidad=resultado.eta_squared["capacidad"],
+        eta_cuadrado_duracion=resultado.eta_squared["duracion"],
+        eta_cuadrado_interaccion=resultado.eta_squared["interaction"],
+        tukey_capacidad=resultado.tukey_capacity,
+        tukey_duracion=resultado.tukey_disruption,
+        r_cuadrado_ajustado=resultado.r_squared,
+        medias_por_configuracion=pd.DataFrame(medias),
+    )
+
+
 def formatear_resultados_anova(resultado: ANOVAResult) -> Dict:
     """Convierte los resultados ANOVA a formato JSON serializable.
 
@@ -1,11 +1,12 @@
 import sys
 import time
 from pathlib import Path
-from concurrent.futures import ProcessPoolExecutor, as_completed
+from concurrent.futures import as_completed
 from datetime import datetime
 from typing import Any
 
 import numpy as np
+from sqlalchemy import insert, update
 from sqlalchemy.orm import Session
 
 _root = Path(__file__).parents[3]
@@ -14,10 +15,43 @@ if str(_root) not in sys.path:
 
 from bll.config import SimulationConfig
 from bll.simulation import run_simulation
+from bll.statistics import CellAggregates
+from bll.worker_pool import get_worker_pool
 
+from app.db.writer import get_writer
 from app.models.configuracion import Configuracion
 from app.models.montecarlo import MonteCarloExperiment, MonteCarloReplica
 from app.models.simulacion import Simulacion
+from app.websocket import progress_manager
+
+
+# Contadores de progreso en memoria: experiment_id -> (completadas, totales).
+# El background task corre en el mismo proceso que la API, así que el endpoint
+# de progreso puede leer el contador sin tocar la base de datos.
+_PROGRESS_COUNTERS: dict[int, tuple[int, int]] = {}
+
+# Intervalo mínimo entre commits de progreso a la base de datos
+_PROGRESS_PERSIST_INTERVAL_S = 1.0
+
+# Réplicas acumuladas antes de encolar un lote hacia el escritor dedicado
+_REPLICA_FLUSH_SIZE = 500
+
+
+def get_progress_counter(experiment_id: int) -> tuple[int, int] | None:
+    return _PROGRESS_COUNTERS.get(experiment_id)
+
+
+def niveles_anova(params: dict) -> tuple[str, str]:
+    """Niveles categóricos (capacidad, duración) de una configuración.
+
+    Mismos cortes que el análisis ANOVA sobre réplicas crudas: un
+    experimento aporta una celda del diseño; la variación entre niveles
+    aparece al combinar los experimentos de una campaña.
+    """
+    cap_nivel = "Status Quo" if params.get("capacidad_hub_tm", 431) <= 450 else "Propuesta"
+    dur_max = params.get("duracion_maxima_disrupcion") or params.get("duracion_disrupcion_max_dias", 14)
+    dur_nivel = "Corta" if dur_max <= 7 else ("Media" if dur_max <= 14 else "Larga")
+    return cap_nivel, dur_nivel
 
 
 def _run_replica(config_params: dict, replica_num: int) -> dict[str, Any]:
@@ -40,11 +74,13 @@ def _run_replica(config_params: dict, replica_num: int) -> dict[str, Any]:
             annual_disruption_rate=config_params.get("tasa_disrupciones_anual", 4.0),
             use_seasonality=config_params.get("usar_estacionalidad", True),
             simulation_days=config_params.get("duracion_simulacion_dias", 365),
-            seed=seed_base * 100000 + replica_num,
+            # Stream hijo independiente por réplica (SeedSequence.spawn),
+            # en vez de la semilla aritmética seed_base * 100000 + réplica
+            seed=seed_base,
+            spawn_key=(replica_num,),
         )
 
-        result = run_simulation(config)
-        del result["time_series"]
+        result = run_simulation(config, collect_time_series=False)
 
         return {
             "replica_numero": replica_num,
@@ -72,54 +108,84 @@ def _run_replica(config_params: dict, replica_num: int) -> dict[str, Any]:
         }
 
 
-def calcular_estadisticas_agregadas(replicas: list[MonteCarloReplica]) -> dict[str, float]:
-    completed = [r for r in replicas if r.estado == "completed"]
-    if not completed:
-        return {}
+# Orden de columnas de la matriz de KPIs agregables
+_KPI_COLUMNS = [
+    "nivel_servicio_pct",
+    "probabilidad_quiebre_stock_pct",
+    "dias_con_quiebre",
+    "inventario_promedio_tm",
+    "inventario_minimo_tm",
+    "autonomia_promedio_dias",
+    "demanda_insatisfecha_tm",
+    "disrupciones_totales",
+]
 
-    def arr(attr):
-        return np.array([getattr(r, attr) for r in completed if getattr(r, attr) is not None])
 
-    ns = arr("nivel_servicio_pct")
-    pq = arr("probabilidad_quiebre_stock_pct")
-    dq = arr("dias_con_quiebre")
-    ip = arr("inventario_promedio_tm")
-    im = arr("inventario_minimo_tm")
-    au = arr("autonomia_promedio_dias")
-    di = arr("demanda_insatisfecha_tm")
-    dr = arr("disrupciones_totales")
+def calcular_estadisticas_desde_matriz(matriz: np.ndarray) -> dict[str, float]:
+    """Estadísticas agregadas desde una matriz (N, 8) con las columnas de
+    _KPI_COLUMNS; los faltantes son NaN. Un solo pase batcheado: una llamada
+    de percentiles con todos los q por todas las columnas a la vez.
+    """
+    valid = ~np.all(np.isnan(matriz), axis=1)
+    matriz = matriz[valid]
+    if matriz.size == 0:
+        return {}
+
+    means = np.nanmean(matriz, axis=0)
+    stds = np.nanstd(matriz, axis=0)
+    pcts = np.nanpercentile(matriz, [25, 50, 75, 95], axis=0)
+    ns = matriz[:, 0]
 
     return {
-        "nivel_servicio_mean": float(np.mean(ns)),
-        "nivel_servicio_std": float(np.std(ns)),
-        "nivel_servicio_min": float(np.min(ns)),
-        "nivel_servicio_max": float(np.max(ns)),
-        "nivel_servicio_p25": float(np.percentile(ns, 25)),
-        "nivel_servicio_p50": float(np.percentile(ns, 50)),
-        "nivel_servicio_p75": float(np.percentile(ns, 75)),
-        "nivel_servicio_p95": float(np.percentile(ns, 95)),
-        "probabilidad_quiebre_stock_mean": float(np.mean(pq)),
-        "probabilidad_quiebre_stock_std": float(np.std(pq)),
-        "probabilidad_quiebre_stock_p50": float(np.percentile(pq, 50)),
-        "probabilidad_quiebre_stock_p95": float(np.percentile(pq, 95)),
-        "dias_con_quiebre_mean": float(np.mean(dq)),
-        "dias_con_quiebre_std": float(np.std(dq)),
-        "dias_con_quiebre_p50": float(np.percentile(dq, 50)),
-        "dias_con_quiebre_p95": float(np.percentile(dq, 95)),
-        "inventario_promedio_mean": float(np.mean(ip)),
-        "inventario_promedio_std": float(np.std(ip)),
-        "inventario_minimo_mean": float(np.mean(im)),
-        "inventario_minimo_std": float(np.std(im)),
-        "autonomia_promedio_mean": float(np.mean(au)),
-        "autonomia_promedio_std": float(np.std(au)),
-        "autonomia_promedio_p50": float(np.percentile(au, 50)),
-        "demanda_insatisfecha_mean": float(np.mean(di)),
-        "demanda_insatisfecha_std": float(np.std(di)),
-        "disrupciones_totales_mean": float(np.mean(dr)),
-        "disrupciones_totales_std": float(np.std(dr)),
+        "nivel_servicio_mean": float(means[0]),
+        "nivel_servicio_std": float(stds[0]),
+        "nivel_servicio_min": float(np.nanmin(ns)),
+        "nivel_servicio_max": float(np.nanmax(ns)),
+        "nivel_servicio_p25": float(pcts[0, 0]),
+        "nivel_servicio_p50": float(pcts[1, 0]),
+        "nivel_servicio_p75": float(pcts[2, 0]),
+        "nivel_servicio_p95": float(pcts[3, 0]),
+        "probabilidad_quiebre_stock_mean": float(means[1]),
+        "probabilidad_quiebre_stock_std": float(stds[1]),
+        "probabilidad_quiebre_stock_p50": float(pcts[1, 1]),
+        "probabilidad_quiebre_stock_p95": float(pcts[3, 1]),
+        "dias_con_quiebre_mean": float(means[2]),
+        "dias_con_quiebre_std": float(stds[2]),
+        "dias_con_quiebre_p50": float(pcts[1, 2]),
+        "dias_con_quiebre_p95": float(pcts[3, 2]),
+        "inventario_promedio_mean": float(means[3]),
+        "inventario_promedio_std": float(stds[3]),
+        "inventario_minimo_mean": float(means[4]),
+        "inventario_minimo_std": float(stds[4]),
+        "autonomia_promedio_mean": float(means[5]),
+        "autonomia_promedio_std": float(stds[5]),
+        "autonomia_promedio_p50": float(pcts[1, 5]),
+        "demanda_insatisfecha_mean": float(means[6]),
+        "demanda_insatisfecha_std": float(stds[6]),
+        "disrupciones_totales_mean": float(means[7]),
+        "disrupciones_totales_std": float(stds[7]),
     }
 
 
+def calcular_estadisticas_agregadas(replicas: list[MonteCarloReplica] | list[dict]) -> dict[str, float]:
+    def field(r, attr):
+        return r.get(attr) if isinstance(r, dict) else getattr(r, attr)
+
+    completed = [r for r in replicas if field(r, "estado") == "completed"]
+    if not completed:
+        return {}
+
+    # Un solo pase sobre las réplicas hacia una matriz contigua
+    matriz = np.full((len(completed), len(_KPI_COLUMNS)), np.nan)
+    for i, r in enumerate(completed):
+        for j, col in enumerate(_KPI_COLUMNS):
+            value = field(r, col)
+            if value is not None:
+                matriz[i, j] = value
+
+    return calcular_estadisticas_desde_matriz(matriz)
+
+
 def ejecutar_experimento_montecarlo(experiment_id: int) -> MonteCarloExperiment:
     from app.db.session import SessionLocal
     db = SessionLocal()
@@ -142,41 +208,118 @@ def ejecutar_experimento_montecarlo(experiment_id: int) -> MonteCarloExperiment:
 
         start_total = time.time()
         params = config.parametros
-        results = []
-
-        with ProcessPoolExecutor(max_workers=exp.max_workers) as executor:
-            futures = {executor.submit(_run_replica, params, i): i for i in range(1, exp.num_replicas + 1)}
-            done = 0
-            for future in as_completed(futures):
-                results.append(future.result())
-                done += 1
-                exp.progreso = int(done / exp.num_replicas * 100)
-                db.commit()
-
-        for res in results:
-            replica = MonteCarloReplica(
-                experiment_id=exp.id,
-                replica_numero=res["replica_numero"],
-                estado=res["estado"],
-                ejecutada_en=datetime.utcnow(),
-                duracion_segundos=res["duracion_segundos"],
-                error_mensaje=res.get("error_mensaje"),
-            )
+
+        # Las escrituras del experimento (lotes de réplicas, progreso,
+        # resultados) se encolan al escritor dedicado; esta sesión solo
+        # lee y hace la transición inicial de estado, así que las
+        # peticiones de la API no compiten con los flushes del runner
+        writer = get_writer()
+        pending_rows: list[dict] = []
+
+        executor = get_worker_pool(exp.max_workers)
+        futures = {executor.submit(_run_replica, params, i): i for i in range(1, exp.num_replicas + 1)}
+        done = 0
+        last_pct = 0
+        last_push_pct = -1
+        last_persist = time.time()
+        # Columnas de KPIs acumuladas en una matriz contigua a medida que
+        # llegan los resultados (base de las estadísticas agregadas)
+        kpi_matrix = np.full((exp.num_replicas, len(_KPI_COLUMNS)), np.nan)
+        # Agregados móviles de nivel de servicio (Welford) para el push
+        sl_n = 0
+        sl_mean = 0.0
+        sl_m2 = 0.0
+        # Estadísticos suficientes para ANOVA (n, suma, suma de cuadrados),
+        # mantenidos a medida que completan las réplicas. Un experimento
+        # aporta una celda capacidad × duración; el endpoint /anova de
+        # campaña fusiona los agregados materializados de varios
+        # experimentos sin recorrer las réplicas
+        cap_nivel, dur_nivel = niveles_anova(params)
+        anova_cells = CellAggregates()
+        for future in as_completed(futures):
+            res = future.result()
+            done += 1
+            _PROGRESS_COUNTERS[exp.id] = (done, exp.num_replicas)
+
+            # Fila plana hacia el lote del escritor (write-behind)
+            row = {
+                "experiment_id": exp.id,
+                "replica_numero": res["replica_numero"],
+                "estado": res["estado"],
+                "ejecutada_en": datetime.utcnow(),
+                "duracion_segundos": res["duracion_segundos"],
+                "error_mensaje": res.get("error_mensaje"),
+            }
             if res["estado"] == "completed" and res["kpis"]:
-                kpis = res["kpis"]
-                replica.nivel_servicio_pct = kpis["nivel_servicio_pct"]
-                replica.probabilidad_quiebre_stock_pct = kpis["probabilidad_quiebre_stock_pct"]
-                replica.dias_con_quiebre = kpis["dias_con_quiebre"]
-                replica.inventario_promedio_tm = kpis["inventario_promedio_tm"]
-                replica.inventario_minimo_tm = kpis["inventario_minimo_tm"]
-                replica.autonomia_promedio_dias = kpis["autonomia_promedio_dias"]
-                replica.demanda_insatisfecha_tm = kpis["demanda_insatisfecha_tm"]
-                replica.disrupciones_totales = kpis["disrupciones_totales"]
-            db.add(replica)
-        db.commit()
+                row.update(res["kpis"])
+            pending_rows.append(row)
+            if len(pending_rows) >= _REPLICA_FLUSH_SIZE:
+                batch = pending_rows
+                pending_rows = []
+                writer.submit(
+                    lambda s, rows=batch: s.execute(insert(MonteCarloReplica), rows)
+                )
 
-        db.refresh(exp)
-        stats = calcular_estadisticas_agregadas(exp.replicas)
+            if res["estado"] == "completed" and res["kpis"]:
+                kpi_matrix[res["replica_numero"] - 1] = [
+                    res["kpis"][col] for col in _KPI_COLUMNS
+                ]
+                value = res["kpis"]["nivel_servicio_pct"]
+                sl_n += 1
+                delta = value - sl_mean
+                sl_mean += delta / sl_n
+                sl_m2 += delta * (value - sl_mean)
+                anova_cells.update(cap_nivel, dur_nivel, value)
+
+            pct = int(done / exp.num_replicas * 100)
+
+            # Push por WebSocket en cada tick de porcentaje (sin tocar la DB)
+            if pct != last_push_pct:
+                ci95 = None
+                if sl_n > 1:
+                    ci95 = 1.96 * (sl_m2 / (sl_n - 1) / sl_n) ** 0.5
+                progress_manager.publish(exp.id, {
+                    "type": "progress",
+                    "experiment_id": exp.id,
+                    "estado": "running",
+                    "progreso": pct,
+                    "replicas_completadas": done,
+                    "replicas_totales": exp.num_replicas,
+                    "nivel_servicio_mean": sl_mean if sl_n > 0 else None,
+                    "nivel_servicio_ci95": ci95,
+                })
+                last_push_pct = pct
+
+            # Persistir de forma acotada: solo al cambiar el porcentaje y
+            # como máximo una vez por intervalo, vía el escritor dedicado
+            now = time.time()
+            if pct != last_pct and now - last_persist >= _PROGRESS_PERSIST_INTERVAL_S:
+                writer.submit(
+                    lambda s, pct=pct: s.execute(
+                        update(MonteCarloExperiment)
+                        .where(MonteCarloExperiment.id == exp.id)
+                        .values(progreso=pct)
+                    )
+                )
+                last_pct = pct
+                last_persist = now
+
+        # Último lote parcial de réplicas
+        if pending_rows:
+            batch = pending_rows
+            pending_rows = []
+            writer.submit(
+                lambda s, rows=batch: s.execute(insert(MonteCarloReplica), rows)
+            )
+
+        # Verificar que todos los lotes de réplicas quedaron commiteados
+        # antes de marcar el experimento como completado: un lote fallido
+        # relanza aquí y el experimento termina en "failed" con su mensaje
+        writer.flush()
+
+        # Estadísticas desde la matriz acumulada en memoria, sin
+        # re-materializar las réplicas recién escritas
+        stats = calcular_estadisticas_desde_matriz(kpi_matrix)
         duration = time.time() - start_total
 
         if stats:
@@ -196,16 +339,35 @@ def ejecutar_experimento_montecarlo(experiment_id: int) -> MonteCarloExperiment:
                 ejecutada_en=datetime.utcnow(),
                 duracion_segundos=duration,
             )
-            db.add(sim)
-            db.commit()
+            writer.submit(lambda s: s.add(sim))
 
-        exp.estado = "completed"
-        exp.progreso = 100
-        exp.completado_en = datetime.utcnow()
-        exp.duracion_segundos = duration
-        exp.resultados_agregados = stats
-        db.commit()
+        writer.submit(
+            lambda s: s.execute(
+                update(MonteCarloExperiment)
+                .where(MonteCarloExperiment.id == exp.id)
+                .values(
+                    estado="completed",
+                    progreso=100,
+                    completado_en=datetime.utcnow(),
+                    duracion_segundos=duration,
+                    resultados_agregados=stats,
+                    anova_agregados=anova_cells.to_dict() if anova_cells.cells else None,
+                )
+            )
+        )
+        # Esperar a que el escritor haya commiteado todo antes de publicar
+        # la finalización: las lecturas posteriores ya ven las réplicas
+        writer.flush()
         db.refresh(exp)
+        progress_manager.publish(exp.id, {
+            "type": "completed",
+            "experiment_id": exp.id,
+            "estado": "completed",
+            "progreso": 100,
+            "replicas_completadas": exp.num_replicas,
+            "replicas_totales": exp.num_replicas,
+            "duracion_segundos": duration,
+        })
         return exp
 
     except Exception as e:
@@ -213,6 +375,13 @@ def ejecutar_experimento_montecarlo(experiment_id: int) -> MonteCarloExperiment:
         exp.error_mensaje = str(e)
         exp.completado_en = datetime.utcnow()
         db.commit()
+        progress_manager.publish(experiment_id, {
+            "type": "failed",
+            "experiment_id": experiment_id,
+            "estado": "failed",
+            "error_mensaje": str(e),
+        })
         raise
     finally:
+        _PROGRESS_COUNTERS.pop(experiment_id, None)
         db.close()
@@ -1,19 +1,35 @@
 """Servicio para Simulaciones."""
 
+import asyncio
+from pathlib import Path
+
 from sqlalchemy.orm import Session, joinedload
 
-from app.core.simulation_runner import run_simulation_async
+from app.config import get_settings
+from app.core.simulation_runner import build_simulation_config, run_simulation_async
 from app.models.configuracion import Configuracion
 from app.models.simulacion import Simulacion
+from dal.metrics_store import DailyMetricsStore
+
+from bll.simulation import run_simulation
 
 
-async def execute_simulation(db: Session, configuracion_id: int) -> Simulacion:
+async def execute_simulation(
+    db: Session,
+    configuracion_id: int,
+    use_cache: bool = True,
+) -> Simulacion:
     """
     Ejecutar simulación para una configuración.
 
+    Si ya existe una simulación completada con el mismo hash de configuración
+    (todos los campos resueltos, semilla incluida) se retorna esa fila sin
+    re-ejecutar; use_cache=False fuerza la re-ejecución.
+
     Args:
         db: Sesión de base de datos
         configuracion_id: ID de la configuración
+        use_cache: Reutilizar resultados cacheados por hash de configuración
 
     Returns:
         Simulación con resultados
@@ -27,10 +43,28 @@ async def execute_simulation(db: Session, configuracion_id: int) -> Simulacion:
     if not config:
         raise ValueError(f"Configuración {configuracion_id} no encontrada")
 
+    # Cache por contenido: mismo hash => misma simulación
+    sim_config = build_simulation_config(config.parametros)
+    config_hash = sim_config.config_hash()
+
+    if use_cache:
+        cached = (
+            db.query(Simulacion)
+            .filter(
+                Simulacion.config_hash == config_hash,
+                Simulacion.estado == "completed",
+            )
+            .order_by(Simulacion.ejecutada_en.desc())
+            .first()
+        )
+        if cached:
+            return cached
+
     # Crear registro de simulación
     db_sim = Simulacion(
         configuracion_id=configuracion_id,
         estado="running",
+        config_hash=config_hash,
     )
     db.add(db_sim)
     db.commit()
@@ -90,3 +124,71 @@ def get_simulaciones(
 async def ejecutar_modelo(params: dict):
     """Ejecutar el modelo de simulación y retornar resultados con series temporales."""
     return await run_simulation_async(params)
+
+
+def _metrics_store_path(simulacion_id: int) -> Path:
+    return Path(get_settings().metrics_store_dir) / f"sim_{simulacion_id}"
+
+
+async def obtener_series_temporales(
+    db: Session,
+    sim: Simulacion,
+    start: int = 0,
+    end: int | None = None,
+    bucket_days: int = 1,
+    width_px: int | None = None,
+) -> tuple[int, list[dict]]:
+    """Series temporales de una simulación, servidas desde el store en disco.
+
+    La primera consulta re-ejecuta la simulación con su misma semilla
+    derramando las métricas diarias a chunks memory-mapped (ver
+    dal/metrics_store.py); las siguientes leen directo del disco. Solo se
+    materializa la ventana [start, end) pedida. Con width_px se elige la
+    resolución precomputada (diaria, semanal o mensual) más fina que cabe
+    en esos píxeles y se sirven las envolventes min/mean/max del rollup;
+    bucket_days > 1 fuerza una resolución explícita. Retorna la resolución
+    efectiva junto con la serie.
+    """
+    store_path = _metrics_store_path(sim.id)
+
+    if DailyMetricsStore.exists(store_path):
+        store = DailyMetricsStore.open(store_path)
+    else:
+        config_db = (
+            db.query(Configuracion)
+            .filter(Configuracion.id == sim.configuracion_id)
+            .first()
+        )
+        if not config_db:
+            raise ValueError("Configuración no encontrada")
+
+        config = build_simulation_config(config_db.parametros)
+        store = DailyMetricsStore(store_path)
+        loop = asyncio.get_event_loop()
+        await loop.run_in_executor(
+            None,
+            lambda: run_simulation(config, collect_time_series=False, metrics_store=store),
+        )
+
+    if width_px is not None:
+        bucket_days = store.resolution_for(width_px)
+
+    if bucket_days > 1:
+        return bucket_days, store.envelope(bucket_days, start, end)
+
+    window = store.window(start, end)
+    days = range(start, start + len(window["inventory"]))
+    return 1, [
+        {
+            "day": day,
+            "inventory": float(window["inventory"][i]),
+            "demand": float(window["demand"][i]),
+            "satisfied_demand": float(window["satisfied_demand"][i]),
+            "supply_received": float(window["supply_received"][i]),
+            "stockout": bool(window["stockout"][i]),
+            "route_blocked": bool(window["route_blocked"][i]),
+            "pending_orders": int(window["pending_orders"][i]),
+            "autonomy_days": float(window["autonomy_days"][i]),
+        }
+        for i, day in enumerate(days)
+    ]
@@ -0,0 +1,55 @@
+"""Canal WebSocket de push para experimentos Monte Carlo.
+
+El runner de experimentos (un background task síncrono) publica ticks de
+progreso y agregados incrementales directamente a los clientes suscritos,
+sin pasar por la base de datos ni requerir polling del frontend.
+"""
+
+import asyncio
+from typing import Any
+
+from fastapi import WebSocket
+
+
+class ExperimentProgressManager:
+    """Registra conexiones por experimento y difunde mensajes JSON.
+
+    `publish` es seguro de llamar desde el hilo del runner: agenda la
+    difusión en el event loop capturado al aceptar conexiones.
+    """
+
+    def __init__(self):
+        self._connections: dict[int, list[WebSocket]] = {}
+        self._loop: asyncio.AbstractEventLoop | None = None
+
+    async def connect(self, experiment_id: int, websocket: WebSocket):
+        await websocket.accept()
+        self._loop = asyncio.get_running_loop()
+        self._connections.setdefault(experiment_id, []).append(websocket)
+
+    def disconnect(self, experiment_id: int, websocket: WebSocket):
+        connections = self._connections.get(experiment_id)
+        if connections and websocket in connections:
+            connections.remove(websocket)
+        if not self._connections.get(experiment_id):
+            self._connections.pop(experiment_id, None)
+
+    async def _broadcast(self, experiment_id: int, message: dict[str, Any]):
+        for websocket in list(self._connections.get(experiment_id, [])):
+            try:
+                await websocket.send_json(message)
+            except Exception:
+                self.disconnect(experiment_id, websocket)
+
+    def publish(self, experiment_id: int, message: dict[str, Any]):
+        """Publica un mensaje a los suscriptores del experimento (no bloqueante)."""
+        if self._loop is None or not self._connections.get(experiment_id):
+            return
+        asyncio.run_coroutine_threadsafe(
+            self._broadcast(experiment_id, message), self._loop
+        )
+
+
+progress_manager = ExperimentProgressManager()
+
+__all__ = ["ExperimentProgressManager", "progress_manager"]
@@ -8,6 +8,17 @@ from .config import (
 )
 from .entities import Hub, Route, OrderInTransit, DailyMetrics
 from .simulation import GLPSimulation, run_simulation
+from .streams import (
+    config_seed_sequence,
+    named_streams,
+    parse_stream_key,
+    replica_seed_sequence,
+    stream_key,
+)
+from .sensitivity import SensitivityResult, run_sensitivity
+from .vectorized import VectorizedGLPSimulation
+from .kernel import CompiledGLPSimulation
+from .worker_pool import get_worker_pool, shutdown_worker_pool
 
 __all__ = [
     "SimulationConfig",
@@ -20,5 +31,16 @@ __all__ = [
     "OrderInTransit",
     "DailyMetrics",
     "GLPSimulation",
+    "VectorizedGLPSimulation",
+    "CompiledGLPSimulation",
     "run_simulation",
+    "config_seed_sequence",
+    "named_streams",
+    "parse_stream_key",
+    "replica_seed_sequence",
+    "stream_key",
+    "SensitivityResult",
+    "run_sensitivity",
+    "get_worker_pool",
+    "shutdown_worker_pool",
 ]
@@ -0,0 +1,180 @@
+from __future__ import annotations
+from typing import Sequence
+
+import numpy as np
+import pandas as pd
+
+from .config import SimulationConfig, SAFETY_MARGIN, MAX_CONCURRENT_ORDERS
+from .simulation import seasonal_demand_profile
+from .streams import named_streams
+
+
+def simulate_batch(
+    config: SimulationConfig,
+    seeds: Sequence[int | np.random.SeedSequence],
+    antithetic: np.ndarray | None = None,
+) -> pd.DataFrame:
+    """Simula todas las réplicas de una celda como un programa de arrays.
+
+    El estado vive en arrays de forma (R,) — inventario, desbloqueo de ruta,
+    slots de órdenes acotados por MAX_CONCURRENT_ORDERS — y el loop avanza por
+    día con operaciones NumPy sobre todas las réplicas a la vez. Retorna la
+    tabla de KPIs por réplica (mismas columnas que calculate_kpis), una fila
+    por semilla.
+    """
+    R = len(seeds)
+    days = config.simulation_days
+    capacity = config.capacity_tm
+    base = config.base_daily_demand_tm
+    lead_time = config.nominal_lead_time_days
+    max_orders = MAX_CONCURRENT_ORDERS
+    rows = np.arange(R)
+
+    # Draws por réplica con los mismos streams nominados que los otros motores
+    noise = np.empty((R, days))
+    unblock_at_day = np.zeros((R, days))
+    total_disruptions = np.zeros(R, dtype=np.int64)
+    total_blocked_days = np.zeros(R)
+    day_idx = np.arange(days)
+
+    for r, seed in enumerate(seeds):
+        if not isinstance(seed, np.random.SeedSequence):
+            seed = np.random.SeedSequence(seed)
+        demand_rng, timing_rng, duration_rng = named_streams(seed)
+
+        noise[r] = demand_rng.normal(1.0, config.demand_variability, days)
+
+        if config.disruption_max_days > 0 and config.annual_disruption_rate > 0:
+            lambda_days = config.annual_disruption_rate / 365.0
+            starts = []
+            durations = []
+            t = 0.0
+            while True:
+                t += timing_rng.exponential(1.0 / lambda_days)
+                if t >= days:
+                    break
+                if config.disruption_min_days == config.disruption_mode_days == config.disruption_max_days:
+                    duration = config.disruption_max_days
+                else:
+                    duration = duration_rng.triangular(
+                        config.disruption_min_days,
+                        config.disruption_mode_days,
+                        config.disruption_max_days
+                    )
+                starts.append(t)
+                durations.append(duration)
+
+            if starts:
+                starts_arr = np.array(starts)
+                ends_arr = starts_arr + np.array(durations)
+                # Desbloqueo vigente en cada día: el del último evento ocurrido
+                idx = np.searchsorted(starts_arr, day_idx, side="right")
+                unblock_at_day[r] = np.where(idx > 0, ends_arr[np.maximum(idx - 1, 0)], 0.0)
+                total_disruptions[r] = len(starts)
+                total_blocked_days[r] = float(np.sum(durations))
+
+    if antithetic is not None:
+        noise[antithetic] = 2.0 - noise[antithetic]
+
+    demand = np.maximum(0.0, base * seasonal_demand_profile(config)[np.newaxis, :] * noise)
+    blocked = day_idx[np.newaxis, :] < unblock_at_day
+
+    # Estado por réplica
+    inventory = np.full(R, config.initial_inventory_tm)
+    order_qty = np.zeros((R, max_orders))
+    order_arrival = np.full((R, max_orders), np.inf)
+    total_received = np.zeros(R)
+    total_dispatched = np.zeros(R)
+    stockout_days = np.zeros(R, dtype=np.int64)
+
+    # Acumuladores de un solo paso para los KPIs de inventario y autonomía
+    inv_sum = np.zeros(R)
+    inv_sumsq = np.zeros(R)
+    inv_min = np.full(R, np.inf)
+    inv_max = np.full(R, -np.inf)
+    aut_sum = np.zeros(R)
+    aut_min = np.full(R, np.inf)
+
+    def process_arrivals(day):
+        # Bloqueo FIFO: una llegada que no cabe detiene las siguientes
+        active = np.ones(R, dtype=bool)
+        for _ in range(max_orders):
+            due = np.where(order_arrival <= day, order_arrival, np.inf)
+            slot = np.argmin(due, axis=1)
+            has_due = due[rows, slot] != np.inf
+            fits = active & has_due & (inventory + order_qty[rows, slot] <= capacity)
+            if not fits.any():
+                break
+            q = np.where(fits, order_qty[rows, slot], 0.0)
+            inventory[:] += q
+            total_received[:] += q
+            order_qty[rows[fits], slot[fits]] = 0.0
+            order_arrival[rows[fits], slot[fits]] = np.inf
+            active = fits
+
+    for day in range(days):
+        process_arrivals(day)
+
+        d = demand[:, day]
+        dispatched = np.minimum(inventory, d)
+        inventory[:] -= dispatched
+        total_dispatched[:] += dispatched
+        stockout_days[:] += dispatched < d
+
+        process_arrivals(day)
+
+        autonomy = np.where(d > 0, inventory / np.where(d > 0, d, 1.0), 0.0)
+        inv_sum += inventory
+        inv_sumsq += inventory ** 2
+        np.minimum(inv_min, inventory, out=inv_min)
+        np.maximum(inv_max, inventory, out=inv_max)
+        aut_sum += autonomy
+        np.minimum(aut_min, autonomy, out=aut_min)
+
+        # Decisión de reorden
+        position = inventory + order_qty.sum(axis=1)
+        pending = (order_arrival != np.inf).sum(axis=1)
+        can_order = (
+            (position <= config.reorder_point_tm) &
+            (pending < max_orders) &
+            ~blocked[:, day]
+        )
+        q = np.minimum(base * lead_time * (1.0 + SAFETY_MARGIN), capacity - inventory)
+        place = can_order & (q > 0)
+        if place.any():
+            empty = order_arrival == np.inf
+            slot = np.argmax(empty, axis=1)
+            order_qty[rows[place], slot[place]] = q[place]
+            order_arrival[rows[place], slot[place]] = day + lead_time
+
+    total_demand = demand.sum(axis=1)
+    satisfied = total_dispatched
+    service_level = np.where(total_demand > 0, satisfied / total_demand * 100.0, 0.0)
+    inv_mean = inv_sum / days
+    inv_std = np.sqrt(np.maximum(inv_sumsq / days - inv_mean ** 2, 0.0))
+
+    return pd.DataFrame({
+        "service_level_pct": np.round(service_level, 4),
+        "stockout_probability_pct": np.round(stockout_days / days * 100.0, 4),
+        "stockout_days": stockout_days,
+        "avg_inventory_tm": np.round(inv_mean, 2),
+        "min_inventory_tm": np.round(inv_min, 2),
+        "max_inventory_tm": np.round(inv_max, 2),
+        "std_inventory_tm": np.round(inv_std, 2),
+        "final_inventory_tm": np.round(inventory, 2),
+        "initial_inventory_tm": np.round(np.full(R, config.initial_inventory_tm), 2),
+        "avg_autonomy_days": np.round(aut_sum / days, 2),
+        "min_autonomy_days": np.round(aut_min, 2),
+        "total_demand_tm": np.round(total_demand, 2),
+        "satisfied_demand_tm": np.round(satisfied, 2),
+        "unsatisfied_demand_tm": np.round(total_demand - satisfied, 2),
+        "avg_daily_demand_tm": np.round(demand.mean(axis=1), 2),
+        "max_daily_demand_tm": np.round(demand.max(axis=1), 2),
+        "min_daily_demand_tm": np.round(demand.min(axis=1), 2),
+        "total_received_tm": np.round(total_received, 2),
+        "total_dispatched_tm": np.round(total_dispatched, 2),
+        "total_disruptions": total_disruptions,
+        "total_blocked_days": np.round(total_blocked_days, 2),
+        "blocked_time_pct": np.round(total_blocked_days / days * 100.0, 2),
+        "simulated_days": np.full(R, days, dtype=np.int64),
+    })
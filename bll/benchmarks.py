@@ -0,0 +1,260 @@
+"""Harness de benchmarks del hot path de simulación.
+
+Mide réplicas/segundo sobre cargas canónicas — las seis celdas del
+factorial a 365 y 3650 días, en un solo proceso y vía run_experiment con
+el pool — con desglose por fase (construcción, avance del reloj, KPIs).
+Los resultados se escriben como JSON con metadatos del entorno, y dos
+archivos de resultados se pueden comparar para marcar regresiones de
+throughput sobre un umbral:
+
+    python -m bll.benchmarks run --output results/bench.json
+    python -m bll.benchmarks compare results/base.json results/bench.json
+"""
+from __future__ import annotations
+
+import argparse
+import json
+import os
+import platform
+import subprocess
+import sys
+import time
+from dataclasses import replace
+from datetime import datetime
+from pathlib import Path
+from typing import Any
+
+import numpy as np
+
+from .config import SimulationConfig, create_factorial_configs
+from .experiment import run_experiment
+from .simulation import GLPSimulation
+
+DEFAULT_DAYS = (365, 3650)
+DEFAULT_THRESHOLD = 0.10
+
+
+def environment_metadata() -> dict[str, Any]:
+    """Metadatos del entorno de la corrida, para contextualizar comparaciones."""
+    try:
+        commit = subprocess.run(
+            ["git", "rev-parse", "--short", "HEAD"],
+            capture_output=True, text=True, timeout=5,
+        ).stdout.strip() or None
+    except Exception:
+        commit = None
+
+    return {
+        "timestamp": datetime.now().isoformat(timespec="seconds"),
+        "python": sys.version.split()[0],
+        "numpy": np.__version__,
+        "platform": platform.platform(),
+        "machine": platform.machine(),
+        "cpu_count": os.cpu_count(),
+        "git_commit": commit,
+    }
+
+
+def _build_simulation(config: SimulationConfig, engine: str):
+    if engine == "vectorized":
+        from .vectorized import VectorizedGLPSimulation
+        return VectorizedGLPSimulation(config)
+    if engine == "compiled":
+        from .kernel import CompiledGLPSimulation
+        return CompiledGLPSimulation(config)
+    return GLPSimulation(config)
+
+
+def benchmark_cell(
+    config: SimulationConfig,
+    replicas: int = 20,
+    engine: str = "simpy",
+) -> dict[str, Any]:
+    """Réplicas/segundo de una celda en un solo proceso, con fases separadas.
+
+    setup = construcción del motor (streams y draws pre-generados),
+    run = avance del reloj de simulación, kpis = agregación final.
+    """
+    phases = {"setup": 0.0, "run": 0.0, "kpis": 0.0}
+
+    start_total = time.perf_counter()
+    for replica in range(1, replicas + 1):
+        cfg = replace(config, spawn_key=(replica,))
+
+        t0 = time.perf_counter()
+        sim = _build_simulation(cfg, engine)
+        t1 = time.perf_counter()
+        sim.run()
+        t2 = time.perf_counter()
+        sim.calculate_kpis()
+        t3 = time.perf_counter()
+
+        phases["setup"] += t1 - t0
+        phases["run"] += t2 - t1
+        phases["kpis"] += t3 - t2
+    seconds = time.perf_counter() - start_total
+
+    return {
+        "replicas": replicas,
+        "seconds": round(seconds, 4),
+        "replicas_per_second": round(replicas / seconds, 2) if seconds > 0 else 0.0,
+        "phases_seconds": {k: round(v, 4) for k, v in phases.items()},
+    }
+
+
+def benchmark_pooled(
+    configs: list[tuple[str, SimulationConfig]],
+    num_replicas: int = 100,
+    max_workers: int | None = None,
+    chunk_size: int = 25,
+) -> dict[str, Any]:
+    """Réplicas/segundo del factorial completo vía run_experiment con el pool."""
+    start = time.perf_counter()
+    df = run_experiment(
+        configs=configs,
+        num_replicas=num_replicas,
+        max_workers=max_workers,
+        chunk_size=chunk_size,
+    )
+    seconds = time.perf_counter() - start
+    total = len(df)
+
+    return {
+        "replicas": total,
+        "seconds": round(seconds, 4),
+        "replicas_per_second": round(total / seconds, 2) if seconds > 0 else 0.0,
+    }
+
+
+def run_benchmarks(
+    days_list: tuple[int, ...] = DEFAULT_DAYS,
+    replicas: int = 20,
+    pooled_replicas: int = 100,
+    max_workers: int | None = None,
+    engine: str = "simpy",
+) -> dict[str, Any]:
+    """Corre todas las cargas canónicas y retorna el dict de resultados."""
+    results: dict[str, Any] = {
+        "environment": environment_metadata(),
+        "engine": engine,
+        "workloads": [],
+    }
+
+    for days in days_list:
+        configs = create_factorial_configs(simulation_days=days)
+        for name, config in configs:
+            measured = benchmark_cell(config, replicas, engine)
+            results["workloads"].append({
+                "workload": f"{name}@{days}d",
+                "mode": "single",
+                **measured,
+            })
+        measured = benchmark_pooled(configs, pooled_replicas, max_workers)
+        results["workloads"].append({
+            "workload": f"factorial@{days}d",
+            "mode": "pooled",
+            **measured,
+        })
+
+    return results
+
+
+def save_results(results: dict[str, Any], path: Path):
+    path = Path(path)
+    path.parent.mkdir(parents=True, exist_ok=True)
+    with open(path, "w") as f:
+        json.dump(results, f, indent=2)
+
+
+def load_results(path: Path) -> dict[str, Any]:
+    with open(path, "r") as f:
+        return json.load(f)
+
+
+def compare_results(
+    baseline: dict[str, Any],
+    candidate: dict[str, Any],
+    threshold: float = DEFAULT_THRESHOLD,
+) -> list[dict[str, Any]]:
+    """Compara dos archivos de resultados carga por carga.
+
+    Marca regresión cuando el throughput del candidato cae más que
+    `threshold` (fracción) respecto del baseline.
+    """
+    base_by_name = {(w["workload"], w["mode"]): w for w in baseline["workloads"]}
+
+    comparison = []
+    for workload in candidate["workloads"]:
+        key = (workload["workload"], workload["mode"])
+        base = base_by_name.get(key)
+        if base is None:
+            continue
+        base_rps = base["replicas_per_second"]
+        cand_rps = workload["replicas_per_second"]
+        change = (cand_rps - base_rps) / base_rps if base_rps > 0 else 0.0
+        comparison.append({
+            "workload": workload["workload"],
+            "mode": workload["mode"],
+            "baseline_rps": base_rps,
+            "candidate_rps": cand_rps,
+            "change_pct": round(change * 100.0, 1),
+            "regression": change < -threshold,
+        })
+    return comparison
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Benchmarks del motor de simulación")
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    run_parser = sub.add_parser("run", help="Correr las cargas canónicas")
+    run_parser.add_argument("--days", type=int, nargs="+", default=list(DEFAULT_DAYS))
+    run_parser.add_argument("--replicas", type=int, default=20,
+                            help="Réplicas por celda en modo single")
+    run_parser.add_argument("--pooled-replicas", type=int, default=100,
+                            help="Réplicas por celda vía run_experiment")
+    run_parser.add_argument("--max-workers", type=int, default=None)
+    run_parser.add_argument("--engine", choices=["simpy", "vectorized", "compiled"],
+                            default="simpy")
+    run_parser.add_argument("--output", type=Path, default=None,
+                            help="Archivo JSON de resultados")
+
+    cmp_parser = sub.add_parser("compare", help="Comparar dos archivos de resultados")
+    cmp_parser.add_argument("baseline", type=Path)
+    cmp_parser.add_argument("candidate", type=Path)
+    cmp_parser.add_argument("--threshold", type=float, default=DEFAULT_THRESHOLD,
+                            help="Caída fraccional de throughput que marca regresión")
+
+    args = parser.parse_args()
+
+    if args.command == "run":
+        results = run_benchmarks(
+            days_list=tuple(args.days),
+            replicas=args.replicas,
+            pooled_replicas=args.pooled_replicas,
+            max_workers=args.max_workers,
+            engine=args.engine,
+        )
+        for workload in results["workloads"]:
+            print(f"{workload['workload']:<24} [{workload['mode']}] "
+                  f"{workload['replicas_per_second']:>8.2f} réplicas/s")
+        if args.output is not None:
+            save_results(results, args.output)
+            print(f"Resultados escritos en {args.output}")
+        return
+
+    comparison = compare_results(
+        load_results(args.baseline), load_results(args.candidate), args.threshold
+    )
+    regressions = [c for c in comparison if c["regression"]]
+    for entry in comparison:
+        flag = "  REGRESIÓN" if entry["regression"] else ""
+        print(f"{entry['workload']:<24} [{entry['mode']}] "
+              f"{entry['baseline_rps']:>8.2f} -> {entry['candidate_rps']:>8.2f} réplicas/s "
+              f"({entry['change_pct']:+.1f}%){flag}")
+    if regressions:
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
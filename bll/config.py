@@ -1,5 +1,6 @@
 from __future__ import annotations
-from dataclasses import dataclass
+import hashlib
+from dataclasses import dataclass, fields
 
 SAFETY_MARGIN = 0.20
 MAX_CONCURRENT_ORDERS = 3
@@ -26,7 +27,14 @@ class SimulationConfig:
     disruption_max_days: float = 21.0
     simulation_days: int = 365
     seed: int = 42
+    # Clave de spawn de SeedSequence: identifica la hija (config, réplica)
+    # dentro de la entropía base sin riesgo de solapamiento de streams
+    # (ver bll/streams.py). Vacía => el stream raíz de `seed`.
+    spawn_key: tuple[int, ...] = ()
     use_seasonality: bool = True
+    # Variante antitética: espeja el ruido de demanda alrededor de su media
+    # (para pares de réplicas con reducción de varianza)
+    antithetic: bool = False
 
     def __post_init__(self):
         self._validate()
@@ -60,6 +68,15 @@ class SimulationConfig:
         if errors:
             raise ValueError(f"Configuración inválida: {'; '.join(errors)}")
 
+    def config_hash(self) -> str:
+        """Hash canónico de todos los campos resueltos (semilla incluida).
+
+        Dos configuraciones con el mismo hash producen la misma simulación,
+        lo que permite cachear resultados por contenido.
+        """
+        values = tuple((f.name, getattr(self, f.name)) for f in fields(self))
+        return hashlib.sha256(repr(values).encode()).hexdigest()
+
     def theoretical_autonomy_days(self) -> float:
         return self.capacity_tm / self.base_daily_demand_tm
 
@@ -0,0 +1,163 @@
+"""Ejecución distribuida de experimentos sobre una cola de trabajo TCP.
+
+El coordinador crea un DistributedExecutor (que publica una cola de tareas
+y una de resultados vía multiprocessing.managers) y lo pasa a
+run_experiment(executor=...); cada nodo del clúster corre
+
+    python -m bll.distributed --host COORDINADOR --port 50515
+
+y consume chunks de réplicas en su pool warm local, devolviendo los
+resultados por la cola de vuelta. El payload de cada tarea es pequeño
+(un SimulationConfig y un rango de réplicas), así que el transporte no
+domina; la acumulación de resultados, el checkpoint y el cache del
+coordinador no cambian porque el backend expone la misma interfaz
+submit()/Future de concurrent.futures.
+"""
+from __future__ import annotations
+
+import argparse
+import itertools
+import threading
+from concurrent.futures import Future
+from multiprocessing.managers import BaseManager
+from queue import Queue
+
+from .worker_pool import get_worker_pool
+
+DEFAULT_PORT = 50515
+DEFAULT_AUTHKEY = b"simres-glp"
+
+
+class _QueueManager(BaseManager):
+    pass
+
+
+class DistributedExecutor:
+    """Backend de ejecución con interfaz submit()/Future sobre la cola.
+
+    Sirve las colas en un hilo del propio proceso coordinador; un hilo
+    colector resuelve cada Future cuando su resultado vuelve de algún
+    nodo. Compatible con concurrent.futures.wait/as_completed, por lo que
+    run_experiment lo usa sin cambios en su loop de acumulación.
+    """
+
+    def __init__(
+        self,
+        host: str = "0.0.0.0",
+        port: int = DEFAULT_PORT,
+        authkey: bytes = DEFAULT_AUTHKEY,
+    ):
+        self._tasks: Queue = Queue()
+        self._results: Queue = Queue()
+        self._futures: dict[int, Future] = {}
+        self._ids = itertools.count()
+        self._lock = threading.Lock()
+        self._shutdown = False
+
+        _QueueManager.register("task_queue", callable=lambda: self._tasks)
+        _QueueManager.register("result_queue", callable=lambda: self._results)
+        manager = _QueueManager(address=(host, port), authkey=authkey)
+        self._server = manager.get_server()
+        self._server_thread = threading.Thread(target=self._server.serve_forever, daemon=True)
+        self._server_thread.start()
+
+        self._collector_thread = threading.Thread(target=self._collect, daemon=True)
+        self._collector_thread.start()
+
+    def submit(self, fn, *args) -> Future:
+        if self._shutdown:
+            raise RuntimeError("DistributedExecutor ya fue cerrado")
+        future: Future = Future()
+        with self._lock:
+            task_id = next(self._ids)
+            self._futures[task_id] = future
+        self._tasks.put((task_id, fn, args))
+        return future
+
+    def _collect(self):
+        while True:
+            item = self._results.get()
+            if item is None:
+                break
+            task_id, ok, payload = item
+            with self._lock:
+                future = self._futures.pop(task_id, None)
+            if future is None:
+                continue
+            if ok:
+                future.set_result(payload)
+            else:
+                future.set_exception(RuntimeError(f"Tarea remota falló: {payload}"))
+
+    def shutdown(self, wait: bool = True):
+        """Publica el centinela de fin para los nodos y detiene el colector."""
+        if self._shutdown:
+            return
+        self._shutdown = True
+        self._tasks.put(None)
+        self._results.put(None)
+        if wait:
+            self._collector_thread.join(timeout=5.0)
+
+
+def run_worker(
+    host: str,
+    port: int = DEFAULT_PORT,
+    authkey: bytes = DEFAULT_AUTHKEY,
+    max_workers: int | None = None,
+):
+    """Loop de un nodo: consume tareas de la cola y las corre en el pool local.
+
+    Mantiene hasta 2x workers chunks en vuelo para saturar el nodo sin
+    acaparar la cola, y re-publica el centinela de fin para que los demás
+    nodos también terminen.
+    """
+    _QueueManager.register("task_queue")
+    _QueueManager.register("result_queue")
+    manager = _QueueManager(address=(host, port), authkey=authkey)
+    manager.connect()
+    tasks = manager.task_queue()
+    results = manager.result_queue()
+
+    pool = get_worker_pool(max_workers)
+    slots = 2 * (getattr(pool, "_max_workers", None) or 1)
+    semaphore = threading.Semaphore(slots)
+
+    def on_done(future: Future, task_id: int):
+        try:
+            results.put((task_id, True, future.result()))
+        except Exception as e:
+            results.put((task_id, False, repr(e)))
+        finally:
+            semaphore.release()
+
+    while True:
+        item = tasks.get()
+        if item is None:
+            tasks.put(None)
+            break
+        task_id, fn, args = item
+        semaphore.acquire()
+        future = pool.submit(fn, *args)
+        future.add_done_callback(lambda f, task_id=task_id: on_done(f, task_id))
+
+    # Esperar los chunks en vuelo antes de salir
+    for _ in range(slots):
+        semaphore.acquire()
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Nodo worker de la cola de trabajo distribuida de experimentos"
+    )
+    parser.add_argument("--host", required=True, help="Host del coordinador")
+    parser.add_argument("--port", type=int, default=DEFAULT_PORT)
+    parser.add_argument("--authkey", default=DEFAULT_AUTHKEY.decode())
+    parser.add_argument("--max-workers", type=int, default=None,
+                        help="Tamaño del pool local (default: núcleos de la máquina)")
+    args = parser.parse_args()
+    run_worker(args.host, args.port, args.authkey.encode(), args.max_workers)
+
+
+if __name__ == "__main__":
+    main()
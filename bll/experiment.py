@@ -1,12 +1,28 @@
 from __future__ import annotations
-from concurrent.futures import ProcessPoolExecutor, as_completed
+from concurrent.futures import FIRST_COMPLETED, as_completed, wait
 from dataclasses import dataclass, replace
+import math
+import os
+import pickle
+import time
+from pathlib import Path
 from typing import Callable
 
+import numpy as np
 import pandas as pd
+from scipy import stats
 
+from dal.checkpoint import CheckpointManager
+from dal.result_cache import SimulationResultCache
+
+from .batch import simulate_batch
 from .config import SimulationConfig, create_factorial_configs
 from .simulation import run_simulation
+from .streams import replica_seed_sequence, sequence_key, stream_key
+from .worker_pool import get_worker_pool
+
+# Tamaño de flush al checkpoint cuando no se usa chunk_size
+DEFAULT_FLUSH_SIZE = 100
 
 
 @dataclass
@@ -14,57 +30,442 @@ class ExperimentResult:
     config_name: str
     replica: int
     kpis: dict
+    config_hash: str | None = None
+    # Clave 'entropía/spawn' del stream de la réplica (ver bll/streams.py):
+    # registrada en la fila para poder re-ejecutarla exactamente
+    stream_key: str | None = None
 
 
 def _run_replica(args: tuple[str, SimulationConfig, int]) -> ExperimentResult | None:
     """Ejecuta una réplica. Retorna None si falla (fail-safe)."""
     config_name, config, replica = args
     try:
-        kpis = run_simulation(config)
-        del kpis["time_series"]
-        return ExperimentResult(config_name, replica, kpis)
+        kpis = run_simulation(config, collect_time_series=False)
+        return ExperimentResult(config_name, replica, kpis, config.config_hash(), stream_key(config))
     except Exception:
         return None
 
 
+def _run_replica_chunk(tasks: list[tuple[str, SimulationConfig, int]]) -> list[ExperimentResult]:
+    """Ejecuta un chunk de réplicas dentro del mismo worker (una tarea por chunk)."""
+    results = []
+    for task in tasks:
+        result = _run_replica(task)
+        if result is not None:
+            results.append(result)
+    return results
+
+
+def _run_replica_chunk_timed(
+    tasks: list[tuple[str, SimulationConfig, int]],
+) -> tuple[list[ExperimentResult], float]:
+    """Chunk cronometrado en el worker, para refinar el costo estimado por celda."""
+    start = time.perf_counter()
+    results = _run_replica_chunk(tasks)
+    return results, time.perf_counter() - start
+
+
+def _expected_replica_cost(config: SimulationConfig) -> float:
+    """Costo relativo esperado de una réplica, para ordenar chunks.
+
+    Proporcional al trabajo del horizonte: los días simulados más el
+    recargo por disrupciones (las celdas Long bloquean la ruta más días,
+    acumulan más órdenes en tránsito y procesan más eventos por día).
+    """
+    mean_duration = (
+        config.disruption_min_days + config.disruption_mode_days + config.disruption_max_days
+    ) / 3.0
+    expected_blocked_frac = config.annual_disruption_rate * mean_duration / 365.0
+    return config.simulation_days * (1.0 + expected_blocked_frac)
+
+
 def run_experiment(
     configs: list[tuple[str, SimulationConfig]] | None = None,
     num_replicas: int = 1000,
     max_workers: int | None = None,
     base_seed: int = 42,
+    chunk_size: int | None = None,
+    checkpoint_dir: Path | None = None,
+    result_cache_dir: Path | None = None,
+    crn: bool = False,
+    antithetic: bool = False,
     on_progress: Callable[[int, int], None] | None = None,
+    executor=None,
+    instrument: bool = False,
 ) -> pd.DataFrame:
+    """Corre la campaña completa y retorna la tabla de KPIs por réplica.
+
+    `executor` acepta cualquier backend con la interfaz submit()/Future de
+    concurrent.futures — por defecto el pool warm local; con un
+    DistributedExecutor (ver bll/distributed.py) los mismos chunks se
+    reparten entre nodos sin cambiar la acumulación ni el checkpoint.
+
+    Con instrument=True se acumula el desglose de las tareas — segundos
+    dentro del worker, espera en cola, bytes serializados de ida y vuelta —
+    en el attrs['perf'] del DataFrame retornado.
+    """
     if configs is None:
         configs = create_factorial_configs(base_seed)
 
+    perf = {
+        "tasks": 0,
+        "worker_seconds": 0.0,
+        "queue_wait_seconds": 0.0,
+        "payload_bytes_sent": 0,
+        "payload_bytes_received": 0,
+    }
+
+    # Resume: cargar réplicas ya completadas desde el checkpoint
+    checkpoint = CheckpointManager(checkpoint_dir) if checkpoint_dir is not None else None
+    results: list[dict] = []
+    previous = pd.DataFrame()
+    completed_pairs: set[tuple[str, int]] = set()
+    batch_num = 0
+    if checkpoint is not None and checkpoint.exists():
+        _, previous = checkpoint.load_dataframe()
+        if not previous.empty:
+            completed_pairs = set(zip(previous["config_name"], previous["replica"]))
+        batch_num = checkpoint.batch_count()
+
+    cache = SimulationResultCache(result_cache_dir) if result_cache_dir is not None else None
+
     tasks = []
     for config_id, (name, base_config) in enumerate(configs, start=1):
         for replica in range(1, num_replicas + 1):
-            seed = base_seed + (config_id - 1) * 1_000_000 + replica
-            config = replace(base_config, seed=seed)
+            if (name, replica) in completed_pairs:
+                continue
+
+            # Variantes antitéticas: las réplicas pares espejan el stream
+            # de la réplica impar anterior
+            stream_replica = replica
+            mirror = False
+            if antithetic:
+                mirror = replica % 2 == 0
+                stream_replica = replica - 1 if mirror else replica
+
+            # Streams hijos independientes por (celda, réplica) vía clave de
+            # spawn de SeedSequence — sin riesgo de solapamiento entre
+            # réplicas. Con crn la clave omite la celda, de modo que las
+            # configuraciones comparadas compartan los streams de demanda y
+            # disrupciones por índice de réplica
+            if crn:
+                key = (stream_replica,)
+            else:
+                key = (config_id, stream_replica)
+
+            config = replace(base_config, seed=base_seed, spawn_key=key, antithetic=mirror)
+
+            # Cache por contenido: pares (config, semilla) ya simulados en
+            # una campaña idéntica no se re-ejecutan
+            if cache is not None:
+                cached = cache.get(config.config_hash())
+                if cached is not None:
+                    results.append({
+                        "config_name": name,
+                        "replica": replica,
+                        "stream_key": stream_key(config),
+                        **cached,
+                    })
+                    continue
+
             tasks.append((name, config, replica))
 
-    results = []
-    completed = 0
-    total = len(tasks)
+    completed = len(previous) + len(results)
+    total = len(tasks) + len(previous) + len(results)
+
+    def finalize() -> pd.DataFrame:
+        df = pd.DataFrame(results)
+        if not previous.empty:
+            df = pd.concat([previous, df], ignore_index=True)
+        if instrument:
+            df.attrs["perf"] = {
+                k: round(v, 4) if isinstance(v, float) else v for k, v in perf.items()
+            }
+        return df
+
+    def flush(batch: list[dict]):
+        nonlocal batch_num
+        if checkpoint is not None and batch:
+            checkpoint.save(completed, batch, batch_num)
+            batch_num += 1
+
+    if chunk_size is not None and chunk_size > 1:
+        # Modo batch con scheduling consciente del trabajo: una tarea por
+        # chunk para amortizar pickling e IPC, chunks ordenados por costo
+        # esperado descendente (las celdas lentas — Long — se drenan
+        # primero, no al final), costo refinado con las duraciones
+        # observadas, y chunks divididos en la cola final para que ningún
+        # core quede ocioso esperando un chunk largo rezagado
+        if executor is None:
+            executor = get_worker_pool(max_workers)
+        workers = getattr(executor, "_max_workers", None) or os.cpu_count() or 1
+
+        estimated = {name: _expected_replica_cost(cfg) for name, cfg in configs}
+        observed: dict[str, float] = {}  # segundos/réplica (EWMA) por celda
+
+        def predicted_cost(name: str) -> float:
+            if name in observed:
+                return observed[name]
+            if observed:
+                # Calibrar las celdas aún no observadas con la razón
+                # segundos-observados / costo-estimado de las ya medidas
+                factor = sum(observed[n] / estimated[n] for n in observed) / len(observed)
+                return estimated[name] * factor
+            return estimated[name]
+
+        queue: list[list[tuple[str, SimulationConfig, int]]] = []
+        by_cell: dict[str, list] = {}
+        for task in tasks:
+            by_cell.setdefault(task[0], []).append(task)
+        for cell_tasks in by_cell.values():
+            for i in range(0, len(cell_tasks), chunk_size):
+                queue.append(cell_tasks[i:i + chunk_size])
+
+        def sort_queue():
+            queue.sort(key=lambda chunk: len(chunk) * predicted_cost(chunk[0][0]), reverse=True)
+
+        in_flight: dict = {}
+
+        def submit_next():
+            if not queue:
+                return
+            # Rebalanceo de cola final: con menos chunks pendientes que
+            # workers, partir el más caro en dos para repartir el trabajo
+            if len(queue) < workers and len(queue[0]) > 1:
+                top = queue.pop(0)
+                half = len(top) // 2
+                queue.insert(0, top[half:])
+                queue.insert(0, top[:half])
+            chunk = queue.pop(0)
+            if instrument:
+                perf["payload_bytes_sent"] += len(pickle.dumps(chunk))
+            in_flight[executor.submit(_run_replica_chunk_timed, chunk)] = (chunk, time.perf_counter())
+
+        sort_queue()
+        for _ in range(min(len(queue), 2 * workers)):
+            submit_next()
+
+        while in_flight:
+            done, _ = wait(in_flight, return_when=FIRST_COMPLETED)
+            for future in done:
+                chunk, submitted_at = in_flight.pop(future)
+                chunk_results, duration = future.result()
+
+                completed += len(chunk)
+                if on_progress:
+                    on_progress(completed, total)
+
+                if instrument:
+                    wall = time.perf_counter() - submitted_at
+                    perf["tasks"] += 1
+                    perf["worker_seconds"] += duration
+                    perf["queue_wait_seconds"] += max(0.0, wall - duration)
+                    perf["payload_bytes_received"] += len(pickle.dumps(chunk_results))
+
+                # Refinar el costo por réplica de la celda con lo observado
+                name = chunk[0][0]
+                per_replica = duration / len(chunk)
+                if name in observed:
+                    observed[name] = 0.5 * observed[name] + 0.5 * per_replica
+                else:
+                    observed[name] = per_replica
+
+                rows = []
+                for result in chunk_results:
+                    rows.append({
+                        "config_name": result.config_name,
+                        "replica": result.replica,
+                        "stream_key": result.stream_key,
+                        **result.kpis
+                    })
+                    if cache is not None and result.config_hash:
+                        cache.put(result.config_hash, result.kpis)
+                results.extend(rows)
+                flush(rows)
+
+                sort_queue()
+                submit_next()
+
+        return finalize()
+
+    pending: list[dict] = []
+    if executor is None:
+        executor = get_worker_pool(max_workers)
 
-    with ProcessPoolExecutor(max_workers=max_workers) as executor:
+    if instrument:
+        # Vía el wrapper cronometrado para conocer los segundos dentro del
+        # worker (la diferencia con el tiempo de pared es espera en cola)
+        futures = {}
+        for task in tasks:
+            perf["payload_bytes_sent"] += len(pickle.dumps(task))
+            futures[executor.submit(_run_replica_chunk_timed, [task])] = (task, time.perf_counter())
+    else:
         futures = {executor.submit(_run_replica, task): task for task in tasks}
-        for future in as_completed(futures):
-            completed += 1
-            if on_progress:
-                on_progress(completed, total)
 
+    for future in as_completed(futures):
+        completed += 1
+        if on_progress:
+            on_progress(completed, total)
+
+        if instrument:
+            chunk_results, duration = future.result()
+            _, submitted_at = futures[future]
+            wall = time.perf_counter() - submitted_at
+            perf["tasks"] += 1
+            perf["worker_seconds"] += duration
+            perf["queue_wait_seconds"] += max(0.0, wall - duration)
+            perf["payload_bytes_received"] += len(pickle.dumps(chunk_results))
+            result = chunk_results[0] if chunk_results else None
+        else:
             result = future.result()
-            if result is None:
+        if result is None:
+            continue
+
+        row = {
+            "config_name": result.config_name,
+            "replica": result.replica,
+            "stream_key": result.stream_key,
+            **result.kpis
+        }
+        results.append(row)
+        if cache is not None and result.config_hash:
+            cache.put(result.config_hash, result.kpis)
+        if checkpoint is not None:
+            pending.append(row)
+            if len(pending) >= DEFAULT_FLUSH_SIZE:
+                flush(pending)
+                pending = []
+
+    flush(pending)
+    return finalize()
+
+
+def run_experiment_batch(
+    configs: list[tuple[str, SimulationConfig]] | None = None,
+    num_replicas: int = 1000,
+    max_workers: int | None = None,
+    base_seed: int = 42,
+    crn: bool = False,
+    antithetic: bool = False,
+    on_progress: Callable[[int, int], None] | None = None,
+    executor=None,
+) -> pd.DataFrame:
+    """Una tarea por celda: todas las réplicas de cada configuración avanzan
+    juntas como un programa de arrays (ver bll/batch.py), en lugar de una
+    tarea del pool por réplica.
+    """
+    if configs is None:
+        configs = create_factorial_configs(base_seed)
+
+    if executor is None:
+        executor = get_worker_pool(max_workers)
+    futures = {}
+    for config_id, (name, base_config) in enumerate(configs, start=1):
+        replicas = np.arange(1, num_replicas + 1)
+        stream_replicas = replicas
+        mirror = None
+        if antithetic:
+            mirror = replicas % 2 == 0
+            stream_replicas = np.where(mirror, replicas - 1, replicas)
+        seed_seqs = [
+            replica_seed_sequence(base_seed, config_id, int(r), crn)
+            for r in stream_replicas
+        ]
+        futures[executor.submit(simulate_batch, base_config, seed_seqs, mirror)] = (name, replicas, seed_seqs)
+
+    frames = []
+    completed = 0
+    total = len(configs) * num_replicas
+
+    for future in as_completed(futures):
+        name, replicas, seed_seqs = futures[future]
+        df = future.result()
+        df.insert(0, "config_name", name)
+        df.insert(1, "replica", replicas)
+        df.insert(2, "stream_key", [sequence_key(ss) for ss in seed_seqs])
+        frames.append(df)
+        completed += len(replicas)
+        if on_progress:
+            on_progress(completed, total)
+
+    return pd.concat(frames, ignore_index=True)
+
+
+def run_experiment_adaptive(
+    configs: list[tuple[str, SimulationConfig]] | None = None,
+    target_half_width: float = 0.1,
+    metric: str = "service_level_pct",
+    min_replicas: int = 100,
+    max_replicas: int = 10_000,
+    eval_interval: int = 100,
+    max_workers: int | None = None,
+    base_seed: int = 42,
+    alpha: float = 0.05,
+    on_progress: Callable[[int, int], None] | None = None,
+    executor=None,
+) -> pd.DataFrame:
+    """Modo de parada secuencial: cada celda corre réplicas en lotes de
+    eval_interval y se detiene cuando la semi-amplitud del IC de `metric`
+    cae bajo target_half_width (o al agotar max_replicas). Las celdas de
+    alta varianza siguen corriendo mientras las convergidas se detienen.
+    """
+    if configs is None:
+        configs = create_factorial_configs(base_seed)
+
+    if executor is None:
+        executor = get_worker_pool(max_workers)
+    results: list[dict] = []
+    state = {
+        name: {"config_id": config_id, "submitted": 0, "values": [], "done": False}
+        for config_id, (name, _) in enumerate(configs, start=1)
+    }
+    config_by_name = {name: base_config for name, base_config in configs}
+
+    completed = 0
+    total_budget = len(configs) * max_replicas
+
+    while any(not st["done"] for st in state.values()):
+        futures = {}
+        for name, st in state.items():
+            if st["done"]:
                 continue
+            base_config = config_by_name[name]
+            config_id = st["config_id"]
+            start = st["submitted"] + 1
+            count = min(eval_interval, max_replicas - st["submitted"])
+            chunk = [
+                (name, replace(base_config, seed=base_seed, spawn_key=(config_id, rep)), rep)
+                for rep in range(start, start + count)
+            ]
+            st["submitted"] += count
+            futures[executor.submit(_run_replica_chunk, chunk)] = name
 
-            row = {
-                "config_name": result.config_name,
-                "replica": result.replica,
-                **result.kpis
-            }
-            results.append(row)
+        for future in as_completed(futures):
+            name = futures[future]
+            st = state[name]
+            for result in future.result():
+                completed += 1
+                results.append({
+                    "config_name": result.config_name,
+                    "replica": result.replica,
+                    "stream_key": result.stream_key,
+                    **result.kpis
+                })
+                st["values"].append(result.kpis[metric])
+            if on_progress:
+                on_progress(completed, total_budget)
+
+            # Evaluar la regla de parada de la celda
+            values = st["values"]
+            n = len(values)
+            if n >= max(min_replicas, 2):
+                std = float(np.std(values, ddof=1))
+                t_crit = stats.t.ppf(1 - alpha / 2, n - 1)
+                margin = t_crit * std / math.sqrt(n)
+                if margin <= target_half_width:
+                    st["done"] = True
+            if st["submitted"] >= max_replicas:
+                st["done"] = True
 
     return pd.DataFrame(results)
 
@@ -88,12 +489,10 @@ def run_experiment_sequential(
             if on_progress:
                 on_progress(completed, total)
 
-            seed = base_seed + (config_id - 1) * 1_000_000 + replica
-            config = replace(base_config, seed=seed)
+            config = replace(base_config, seed=base_seed, spawn_key=(config_id, replica))
             try:
-                kpis = run_simulation(config)
-                del kpis["time_series"]
-                row = {"config_name": name, "replica": replica, **kpis}
+                kpis = run_simulation(config, collect_time_series=False)
+                row = {"config_name": name, "replica": replica, "stream_key": stream_key(config), **kpis}
                 results.append(row)
             except Exception:
                 continue
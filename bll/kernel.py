@@ -0,0 +1,133 @@
+from __future__ import annotations
+
+import numpy as np
+
+from .config import MAX_CONCURRENT_ORDERS, SAFETY_MARGIN
+from .vectorized import VectorizedGLPSimulation
+
+try:
+    from numba import njit
+    HAS_NUMBA = True
+except ImportError:
+    HAS_NUMBA = False
+
+
+def _day_loop(demand, disruption_starts, disruption_durations,
+              initial_inventory, capacity, reorder_point, base_demand,
+              lead_time, safety_margin, max_orders,
+              inventory_out, satisfied_out, supply_out, stockout_out,
+              blocked_out, pending_out, autonomy_out):
+    """Máquina de estados del paso diario (balance de inventario, decisión de
+    reorden, envejecimiento de órdenes en tránsito, cuenta regresiva de
+    bloqueo) sobre buffers pre-generados. Compilable por numba.njit; el mismo
+    cuerpo corre como Python puro cuando el compilador no está disponible.
+    """
+    days = demand.shape[0]
+    inventory = initial_inventory
+    total_received = 0.0
+    total_dispatched = 0.0
+    unblock_time = 0.0
+    next_event = 0
+    n_events = disruption_starts.shape[0]
+
+    # Cola FIFO de órdenes en tránsito sobre slots fijos
+    order_qty = np.zeros(max_orders)
+    order_arrival = np.zeros(max_orders)
+    head = 0
+    count = 0
+
+    for day in range(days):
+        while next_event < n_events and disruption_starts[next_event] <= day:
+            unblock_time = disruption_starts[next_event] + disruption_durations[next_event]
+            next_event += 1
+        blocked = day < unblock_time
+
+        # Llegadas de suministro vencidas (bloqueo FIFO por capacidad)
+        while count > 0 and order_arrival[head] <= day and inventory + order_qty[head] <= capacity:
+            q = order_qty[head]
+            inventory += q
+            total_received += q
+            supply_out[day] += q
+            head = (head + 1) % max_orders
+            count -= 1
+
+        d = demand[day]
+        dispatched = d if inventory >= d else inventory
+        inventory -= dispatched
+        total_dispatched += dispatched
+
+        # Reintento de llegadas que esperaban espacio
+        while count > 0 and order_arrival[head] <= day and inventory + order_qty[head] <= capacity:
+            q = order_qty[head]
+            inventory += q
+            total_received += q
+            supply_out[day] += q
+            head = (head + 1) % max_orders
+            count -= 1
+
+        inventory_out[day] = inventory
+        satisfied_out[day] = dispatched
+        stockout_out[day] = dispatched < d
+        blocked_out[day] = blocked
+        pending_out[day] = count
+        autonomy_out[day] = inventory / d if d > 0 else 0.0
+
+        # Decisión de reorden
+        position = inventory
+        for i in range(count):
+            position += order_qty[(head + i) % max_orders]
+        if position <= reorder_point and count < max_orders and not blocked:
+            q = base_demand * lead_time * (1.0 + safety_margin)
+            available = capacity - inventory
+            if q > available:
+                q = available
+            if q > 0.0:
+                tail = (head + count) % max_orders
+                order_qty[tail] = q
+                order_arrival[tail] = day + lead_time
+                count += 1
+
+    return inventory, total_received, total_dispatched
+
+
+if HAS_NUMBA:
+    _day_loop_jit = njit(cache=True)(_day_loop)
+else:
+    _day_loop_jit = _day_loop
+
+
+class CompiledGLPSimulation(VectorizedGLPSimulation):
+    """Variante del motor vectorizado cuyo loop diario corre en el kernel
+    compilado. Mismos draws, buffers y KPIs que VectorizedGLPSimulation.
+    """
+
+    def run(self):
+        cfg = self.config
+        demand = np.maximum(0.0, cfg.base_daily_demand_tm * self._seasonal * self._demand_noise)
+        self.demand_tm[:] = demand
+
+        final_inventory, total_received, total_dispatched = _day_loop_jit(
+            demand,
+            self._disruption_starts,
+            self._disruption_durations,
+            cfg.initial_inventory_tm,
+            cfg.capacity_tm,
+            cfg.reorder_point_tm,
+            cfg.base_daily_demand_tm,
+            cfg.nominal_lead_time_days,
+            SAFETY_MARGIN,
+            MAX_CONCURRENT_ORDERS,
+            self.inventory_tm,
+            self.satisfied_demand_tm,
+            self.supply_received_tm,
+            self.stockout,
+            self.route_blocked,
+            self.pending_orders,
+            self.autonomy_days,
+        )
+
+        self.final_inventory_tm = float(final_inventory)
+        self.total_received_tm = float(total_received)
+        self.total_dispatched_tm = float(total_dispatched)
+        self.total_demand_tm = float(np.sum(demand))
+        self.satisfied_total_tm = float(np.sum(self.satisfied_demand_tm))
@@ -1,26 +1,106 @@
 from __future__ import annotations
 import math
+import time
 from typing import Any
 
 import simpy
 import numpy as np
 
+from dal.metrics_store import DailyMetricsStore
+
 from .config import SimulationConfig, SAFETY_MARGIN, MAX_CONCURRENT_ORDERS
 from .entities import Hub, Route, OrderInTransit, DailyMetrics
+from .streams import config_seed_sequence, named_streams
+
+_SEASONAL_PROFILE_CACHE: dict[tuple, np.ndarray] = {}
+
+
+def seasonal_demand_profile(config: SimulationConfig) -> np.ndarray:
+    """Multiplicador estacional por día, memoizado por parámetros de estacionalidad.
+
+    El perfil depende solo de campos constantes entre réplicas de una misma
+    celda de configuración, así que se calcula una vez y se comparte.
+    """
+    key = (
+        config.simulation_days,
+        config.use_seasonality,
+        config.seasonal_amplitude,
+        config.peak_winter_day,
+    )
+    profile = _SEASONAL_PROFILE_CACHE.get(key)
+    if profile is None:
+        if config.use_seasonality:
+            days = np.arange(config.simulation_days)
+            phase = 2 * math.pi * (days - config.peak_winter_day) / 365.0
+            profile = 1.0 + config.seasonal_amplitude * np.sin(phase)
+        else:
+            profile = np.ones(config.simulation_days)
+        profile.setflags(write=False)
+        _SEASONAL_PROFILE_CACHE[key] = profile
+    return profile
 
 
 class GLPSimulation:
-    def __init__(self, config: SimulationConfig):
+    def __init__(
+        self,
+        config: SimulationConfig,
+        metrics_store: DailyMetricsStore | None = None,
+        instrument: bool = False,
+    ):
         self.config = config
-        self.rng = np.random.default_rng(config.seed)
+        self.metrics_store = metrics_store
+        # Instrumentación opt-in: contadores de tiempo de pared por fase del
+        # hot path, expuestos como bloque _perf en el dict de KPIs. Sin
+        # instrumentar no se toca el reloj en el loop diario.
+        self._instrument = instrument
+        self._perf = {
+            "demand_s": 0.0,
+            "replenishment_s": 0.0,
+            "supply_s": 0.0,
+            "disruption_s": 0.0,
+            "kpis_s": 0.0,
+        }
+        # Streams nominados por propósito (ruido de demanda, timing de
+        # disrupciones, duración de disrupciones) derivados de la misma
+        # SeedSequence: permite números aleatorios comunes entre
+        # configuraciones sin que un consumo distinto de un stream
+        # desalinee los otros (ver bll/streams.py)
+        self.demand_rng, self.disruption_timing_rng, self.disruption_duration_rng = \
+            named_streams(config_seed_sequence(config))
+        self.rng = self.demand_rng
         self.env = simpy.Environment()
         self.hub = Hub(self.env, config)
         self.route = Route(self.env, config, self.rng)
         self.orders_in_transit: list[OrderInTransit] = []
-        self.daily_metrics: list[DailyMetrics] = []
+        self._seasonal = seasonal_demand_profile(config)
+        # Set completo de draws de demanda en una sola llamada al generador
+        # (en vez de ~365 despachos escalares por réplica); misma secuencia
+        # de valores que las llamadas de a uno
+        self._demand_noise = self.demand_rng.normal(
+            1.0, config.demand_variability, config.simulation_days
+        )
+        if config.antithetic:
+            self._demand_noise = 2.0 - self._demand_noise
         self.total_demand_tm = 0.0
         self.satisfied_demand_tm = 0.0
 
+        # Buffers columnarios preasignados (una columna por campo de
+        # DailyMetrics). En modo streaming las métricas van directo al
+        # store en chunks mapeados a disco y no se preasigna el horizonte
+        # completo: la memoria por réplica queda acotada por el tamaño de
+        # chunk, no por los días simulados.
+        if metrics_store is None:
+            days = config.simulation_days
+            self.inventory_col = np.zeros(days)
+            self.demand_col = np.zeros(days)
+            self.satisfied_demand_col = np.zeros(days)
+            self.supply_received_col = np.zeros(days)
+            self.stockout_col = np.zeros(days, dtype=bool)
+            self.route_blocked_col = np.zeros(days, dtype=bool)
+            self.pending_orders_col = np.zeros(days, dtype=np.int64)
+            self.autonomy_col = np.zeros(days)
+        self.days_recorded = 0
+
     def run(self):
         self.env.process(self._demand_process())
         self.env.process(self._replenishment_process())
@@ -29,13 +109,8 @@ class GLPSimulation:
 
     def _calculate_demand(self, day: int) -> float:
         base = self.config.base_daily_demand_tm
-        if self.config.use_seasonality:
-            phase = 2 * math.pi * (day - self.config.peak_winter_day) / 365.0
-            seasonal = 1.0 + self.config.seasonal_amplitude * math.sin(phase)
-        else:
-            seasonal = 1.0
-        noise = self.rng.normal(1.0, self.config.demand_variability)
-        return max(0.0, base * seasonal * noise)
+        seasonal = self._seasonal[day]
+        return max(0.0, base * seasonal * self._demand_noise[day])
 
     def _inventory_in_transit(self) -> float:
         return sum(o.quantity_tm for o in self.orders_in_transit)
@@ -53,6 +128,7 @@ class GLPSimulation:
     def _demand_process(self):
         day = 0
         while True:
+            t0 = time.perf_counter() if self._instrument else 0.0
             demand = self._calculate_demand(day)
             dispatched = self.hub.dispatch(demand)
             self.total_demand_tm += demand
@@ -63,22 +139,34 @@ class GLPSimulation:
 
             is_blocked = self.route._blocked and self.env.now < self.route._unblock_time
 
-            self.daily_metrics.append(DailyMetrics(
-                day=day,
-                inventory_tm=inv,
-                demand_tm=demand,
-                satisfied_demand_tm=dispatched,
-                supply_received_tm=0.0,
-                stockout=(dispatched < demand),
-                route_blocked=is_blocked,
-                pending_orders=len(self.orders_in_transit),
-                autonomy_days=autonomy
-            ))
+            if self.metrics_store is not None:
+                self.metrics_store.append(
+                    inventory=inv,
+                    demand=demand,
+                    satisfied_demand=dispatched,
+                    supply_received=0.0,
+                    stockout=dispatched < demand,
+                    route_blocked=is_blocked,
+                    pending_orders=len(self.orders_in_transit),
+                    autonomy_days=autonomy,
+                )
+            else:
+                self.inventory_col[day] = inv
+                self.demand_col[day] = demand
+                self.satisfied_demand_col[day] = dispatched
+                self.stockout_col[day] = dispatched < demand
+                self.route_blocked_col[day] = is_blocked
+                self.pending_orders_col[day] = len(self.orders_in_transit)
+                self.autonomy_col[day] = autonomy
+            self.days_recorded = day + 1
+            if self._instrument:
+                self._perf["demand_s"] += time.perf_counter() - t0
             yield self.env.timeout(1.0)
             day += 1
 
     def _replenishment_process(self):
         while True:
+            t0 = time.perf_counter() if self._instrument else 0.0
             position = self._position_inventory()
             can_order = (
                 position <= self.config.reorder_point_tm and
@@ -92,67 +180,167 @@ class GLPSimulation:
                     order = OrderInTransit(quantity, lt, self.env.now)
                     self.orders_in_transit.append(order)
                     self.env.process(self._supply_arrival(order))
+            if self._instrument:
+                self._perf["replenishment_s"] += time.perf_counter() - t0
             yield self.env.timeout(1.0)
 
     def _supply_arrival(self, order: OrderInTransit):
         yield self.env.timeout(order.lead_time_days)
         yield self.hub.receive_supply(order.quantity_tm)
-        if self.daily_metrics:
-            self.daily_metrics[-1].supply_received_tm += order.quantity_tm
+        # Solo se cronometra el registro posterior a los yields: el tiempo
+        # de pared a través de un yield incluiría los demás eventos
+        t0 = time.perf_counter() if self._instrument else 0.0
+        if self.days_recorded > 0:
+            if self.metrics_store is not None:
+                self.metrics_store.add_supply_received(self.days_recorded - 1, order.quantity_tm)
+            else:
+                self.supply_received_col[self.days_recorded - 1] += order.quantity_tm
         if order in self.orders_in_transit:
             self.orders_in_transit.remove(order)
+        if self._instrument:
+            self._perf["supply_s"] += time.perf_counter() - t0
 
     def _disruption_process(self):
         if self.config.disruption_max_days <= 0 or self.config.annual_disruption_rate <= 0:
             return
 
         lambda_days = self.config.annual_disruption_rate / 365.0
+        constant_duration = (
+            self.config.disruption_min_days == self.config.disruption_mode_days == self.config.disruption_max_days
+        )
+
+        # Draws por lotes: un batch cubre ~2x el número esperado de eventos
+        # del horizonte; si se agota (cola de la Poisson) se pide otro al
+        # mismo generador, que continúa su secuencia
+        batch = max(8, int(2 * lambda_days * self.config.simulation_days) + 8)
+        interarrivals = self.disruption_timing_rng.exponential(1.0 / lambda_days, batch)
+        if constant_duration:
+            durations = np.full(batch, self.config.disruption_max_days)
+        else:
+            durations = self.disruption_duration_rng.triangular(
+                self.config.disruption_min_days,
+                self.config.disruption_mode_days,
+                self.config.disruption_max_days,
+                batch,
+            )
+        index = 0
+
         while True:
-            time_to_next = self.rng.exponential(1.0 / lambda_days)
-            yield self.env.timeout(time_to_next)
+            t0 = time.perf_counter() if self._instrument else 0.0
+            if index >= batch:
+                interarrivals = self.disruption_timing_rng.exponential(1.0 / lambda_days, batch)
+                if not constant_duration:
+                    durations = self.disruption_duration_rng.triangular(
+                        self.config.disruption_min_days,
+                        self.config.disruption_mode_days,
+                        self.config.disruption_max_days,
+                        batch,
+                    )
+                index = 0
+            if self._instrument:
+                self._perf["disruption_s"] += time.perf_counter() - t0
 
-            if self.config.disruption_min_days == self.config.disruption_mode_days == self.config.disruption_max_days:
-                duration = self.config.disruption_max_days
-            else:
-                duration = self.rng.triangular(
-                    self.config.disruption_min_days,
-                    self.config.disruption_mode_days,
-                    self.config.disruption_max_days
-                )
-            self.route.block(duration)
+            yield self.env.timeout(interarrivals[index])
+            t0 = time.perf_counter() if self._instrument else 0.0
+            self.route.block(float(durations[index]))
+            index += 1
+            if self._instrument:
+                self._perf["disruption_s"] += time.perf_counter() - t0
+
+    def _window_columns(self) -> dict[str, np.ndarray]:
+        """Columnas registradas, desde los buffers o desde el store."""
+        if self.metrics_store is not None:
+            w = self.metrics_store.window(0, self.days_recorded)
+            return {
+                "inventory": w["inventory"],
+                "demand": w["demand"],
+                "satisfied_demand": w["satisfied_demand"],
+                "supply_received": w["supply_received"],
+                "stockout": w["stockout"],
+                "route_blocked": w["route_blocked"],
+                "pending_orders": w["pending_orders"],
+                "autonomy_days": w["autonomy_days"],
+            }
+        n = self.days_recorded
+        return {
+            "inventory": self.inventory_col[:n],
+            "demand": self.demand_col[:n],
+            "satisfied_demand": self.satisfied_demand_col[:n],
+            "supply_received": self.supply_received_col[:n],
+            "stockout": self.stockout_col[:n],
+            "route_blocked": self.route_blocked_col[:n],
+            "pending_orders": self.pending_orders_col[:n],
+            "autonomy_days": self.autonomy_col[:n],
+        }
+
+    @property
+    def daily_metrics(self) -> list[DailyMetrics]:
+        """Vista de compatibilidad sobre los buffers columnarios."""
+        cols = self._window_columns()
+        return [
+            DailyMetrics(
+                day=day,
+                inventory_tm=float(cols["inventory"][day]),
+                demand_tm=float(cols["demand"][day]),
+                satisfied_demand_tm=float(cols["satisfied_demand"][day]),
+                supply_received_tm=float(cols["supply_received"][day]),
+                stockout=bool(cols["stockout"][day]),
+                route_blocked=bool(cols["route_blocked"][day]),
+                pending_orders=int(cols["pending_orders"][day]),
+                autonomy_days=float(cols["autonomy_days"][day]),
+            )
+            for day in range(self.days_recorded)
+        ]
 
     def calculate_kpis(self) -> dict[str, Any]:
-        if not self.daily_metrics:
+        if self.days_recorded == 0:
             return {}
 
-        inventories = [m.inventory_tm for m in self.daily_metrics]
-        autonomies = [m.autonomy_days for m in self.daily_metrics]
-        demands = [m.demand_tm for m in self.daily_metrics]
-        stockout_days = sum(1 for m in self.daily_metrics if m.stockout)
-        total_days = len(self.daily_metrics)
+        t0 = time.perf_counter() if self._instrument else 0.0
+        total_days = self.days_recorded
+        if self.metrics_store is not None:
+            # Estadísticos acumulados chunk a chunk, sin traer la serie a memoria
+            agg = self.metrics_store.aggregates()
+            inv = agg["inventory"]
+            aut = agg["autonomy_days"]
+            dem = agg["demand"]
+            stockout_days = agg["stockout_days"]
+            avg_inv, min_inv, max_inv, std_inv = inv["mean"], inv["min"], inv["max"], inv["std"]
+            avg_aut, min_aut = aut["mean"], aut["min"]
+            avg_dem, min_dem, max_dem = dem["mean"], dem["min"], dem["max"]
+        else:
+            inventories = self.inventory_col[:total_days]
+            autonomies = self.autonomy_col[:total_days]
+            demands = self.demand_col[:total_days]
+            stockout_days = int(np.sum(self.stockout_col[:total_days]))
+            avg_inv, min_inv = float(np.mean(inventories)), float(np.min(inventories))
+            max_inv, std_inv = float(np.max(inventories)), float(np.std(inventories))
+            avg_aut, min_aut = float(np.mean(autonomies)), float(np.min(autonomies))
+            avg_dem = float(np.mean(demands))
+            min_dem, max_dem = float(np.min(demands)), float(np.max(demands))
 
         service_level = (self.satisfied_demand_tm / self.total_demand_tm * 100.0) if self.total_demand_tm > 0 else 0.0
         stockout_prob = (stockout_days / total_days * 100.0) if total_days > 0 else 0.0
         blocked_pct = (self.route.total_blocked_days / self.config.simulation_days * 100.0)
 
-        return {
+        kpis = {
             "service_level_pct": round(service_level, 4),
             "stockout_probability_pct": round(stockout_prob, 4),
             "stockout_days": stockout_days,
-            "avg_inventory_tm": round(float(np.mean(inventories)), 2),
-            "min_inventory_tm": round(float(np.min(inventories)), 2),
-            "max_inventory_tm": round(float(np.max(inventories)), 2),
-            "std_inventory_tm": round(float(np.std(inventories)), 2),
+            "avg_inventory_tm": round(avg_inv, 2),
+            "min_inventory_tm": round(min_inv, 2),
+            "max_inventory_tm": round(max_inv, 2),
+            "std_inventory_tm": round(std_inv, 2),
             "final_inventory_tm": round(self.hub.inventory.level, 2),
             "initial_inventory_tm": round(self.config.initial_inventory_tm, 2),
-            "avg_autonomy_days": round(float(np.mean(autonomies)), 2),
-            "min_autonomy_days": round(float(np.min(autonomies)), 2),
+            "avg_autonomy_days": round(avg_aut, 2),
+            "min_autonomy_days": round(min_aut, 2),
             "total_demand_tm": round(self.total_demand_tm, 2),
             "satisfied_demand_tm": round(self.satisfied_demand_tm, 2),
             "unsatisfied_demand_tm": round(self.total_demand_tm - self.satisfied_demand_tm, 2),
-            "avg_daily_demand_tm": round(float(np.mean(demands)), 2),
-            "max_daily_demand_tm": round(float(np.max(demands)), 2),
-            "min_daily_demand_tm": round(float(np.min(demands)), 2),
+            "avg_daily_demand_tm": round(avg_dem, 2),
+            "max_daily_demand_tm": round(max_dem, 2),
+            "min_daily_demand_tm": round(min_dem, 2),
             "total_received_tm": round(self.hub.total_received_tm, 2),
             "total_dispatched_tm": round(self.hub.total_dispatched_tm, 2),
             "total_disruptions": self.route.total_disruptions,
@@ -161,23 +349,79 @@ class GLPSimulation:
             "simulated_days": total_days,
         }
 
+        if self._instrument:
+            self._perf["kpis_s"] += time.perf_counter() - t0
+            kpis["_perf"] = {k: round(v, 6) for k, v in self._perf.items()}
+
+        return kpis
+
+    def build_time_series(self) -> list[dict[str, Any]]:
+        cols = self._window_columns()
+        return [
+            {
+                "day": day,
+                "inventory": float(cols["inventory"][day]),
+                "demand": float(cols["demand"][day]),
+                "satisfied_demand": float(cols["satisfied_demand"][day]),
+                "supply_received": float(cols["supply_received"][day]),
+                "stockout": bool(cols["stockout"][day]),
+                "route_blocked": bool(cols["route_blocked"][day]),
+                "pending_orders": int(cols["pending_orders"][day]),
+                "autonomy_days": float(cols["autonomy_days"][day]),
+            }
+            for day in range(self.days_recorded)
+        ]
+
+
+def run_simulation(
+    config: SimulationConfig,
+    engine: str = "simpy",
+    collect_time_series: bool = True,
+    metrics_store: DailyMetricsStore | None = None,
+    instrument: bool = False,
+) -> dict[str, Any]:
+    """Ejecuta una réplica y retorna sus KPIs.
+
+    Con instrument=True el motor SimPy acumula tiempo de pared por fase
+    (demanda, reposición, llegadas, disrupciones, KPIs) y lo adjunta como
+    bloque _perf del dict de KPIs.
+
+    Con metrics_store las métricas diarias se derraman a disco en chunks
+    (ver dal/metrics_store.py) en lugar de adjuntarse como time_series al
+    dict de resultados; el consumidor sirve ventanas o agregados desde el
+    store. Pensado para horizontes multi-año donde la serie completa en
+    memoria/JSON es prohibitiva.
+    """
+    if engine == "vectorized":
+        from .vectorized import VectorizedGLPSimulation
+        sim: GLPSimulation | VectorizedGLPSimulation = VectorizedGLPSimulation(config)
+    elif engine == "compiled":
+        from .kernel import CompiledGLPSimulation
+        sim = CompiledGLPSimulation(config)
+    elif engine == "simpy":
+        sim = GLPSimulation(config, metrics_store=metrics_store, instrument=instrument)
+    else:
+        raise ValueError(f"engine debe ser 'simpy', 'vectorized' o 'compiled', no {engine!r}")
 
-def run_simulation(config: SimulationConfig) -> dict[str, Any]:
-    sim = GLPSimulation(config)
     sim.run()
+
+    if metrics_store is not None:
+        if engine != "simpy":
+            # Los motores vectorizados ya tienen las columnas completas en
+            # memoria: se vuelcan al store chunk a chunk al terminar
+            metrics_store.append_block(
+                inventory=sim.inventory_tm,
+                demand=sim.demand_tm,
+                satisfied_demand=sim.satisfied_demand_tm,
+                supply_received=sim.supply_received_tm,
+                stockout=sim.stockout,
+                route_blocked=sim.route_blocked,
+                pending_orders=sim.pending_orders,
+                autonomy_days=sim.autonomy_days,
+            )
+        metrics_store.close()
+
     kpis = sim.calculate_kpis()
-    kpis["time_series"] = [
-        {
-            "day": m.day,
-            "inventory": m.inventory_tm,
-            "demand": m.demand_tm,
-            "satisfied_demand": m.satisfied_demand_tm,
-            "supply_received": m.supply_received_tm,
-            "stockout": m.stockout,
-            "route_blocked": m.route_blocked,
-            "pending_orders": m.pending_orders,
-            "autonomy_days": m.autonomy_days,
-        }
-        for m in sim.daily_metrics
-    ]
+    if collect_time_series and metrics_store is None:
+        kpis["time_series"] = sim.build_time_series()
     return kpis
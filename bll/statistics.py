@@ -1,4 +1,5 @@
 from __future__ import annotations
+import math
 from dataclasses import dataclass
 from typing import Any
 
@@ -26,6 +27,198 @@ class AnovaResult:
     tukey_disruption: pd.DataFrame | None
 
 
+class CellAggregates:
+    """Estadísticos suficientes por celda del diseño: (n, suma, suma de
+    cuadrados) por combinación de niveles de los dos factores.
+
+    Se mantienen incrementalmente a medida que completan las réplicas
+    (update por valor, merge entre campañas) y son JSON-serializables
+    (to_dict/from_dict) para materializarlos junto a los resultados. La
+    tabla ANOVA, eta cuadrado y Tukey se derivan de estos agregados en
+    O(celdas), independiente del número de réplicas.
+    """
+
+    def __init__(self):
+        # (nivel_factor1, nivel_factor2) -> [n, suma, suma_cuadrados]
+        self.cells: dict[tuple[str, str], list[float]] = {}
+
+    def update(self, level1: str, level2: str, value: float):
+        cell = self.cells.setdefault((level1, level2), [0, 0.0, 0.0])
+        cell[0] += 1
+        cell[1] += value
+        cell[2] += value * value
+
+    def merge(self, other: "CellAggregates"):
+        for key, (n, s, ss) in other.cells.items():
+            cell = self.cells.setdefault(key, [0, 0.0, 0.0])
+            cell[0] += n
+            cell[1] += s
+            cell[2] += ss
+
+    @classmethod
+    def from_dataframe(
+        cls,
+        df: pd.DataFrame,
+        response: str,
+        factor1: str,
+        factor2: str,
+    ) -> "CellAggregates":
+        agg = cls()
+        grouped = df.groupby([factor1, factor2])[response].agg(["count", "sum", lambda x: float(np.sum(x ** 2))])
+        for (l1, l2), row in grouped.iterrows():
+            agg.cells[(str(l1), str(l2))] = [int(row.iloc[0]), float(row.iloc[1]), float(row.iloc[2])]
+        return agg
+
+    def to_dict(self) -> dict:
+        return {f"{l1}|{l2}": cell for (l1, l2), cell in self.cells.items()}
+
+    @classmethod
+    def from_dict(cls, data: dict) -> "CellAggregates":
+        agg = cls()
+        for key, cell in data.items():
+            l1, _, l2 = key.partition("|")
+            agg.cells[(l1, l2)] = [int(cell[0]), float(cell[1]), float(cell[2])]
+        return agg
+
+    def levels(self) -> tuple[list[str], list[str]]:
+        return (
+            sorted({l1 for l1, _ in self.cells}),
+            sorted({l2 for _, l2 in self.cells}),
+        )
+
+
+def _tukey_from_aggregates(
+    level_stats: dict[str, tuple[int, float]],
+    ms_error: float,
+    df_error: int,
+    alpha: float = 0.05,
+) -> pd.DataFrame:
+    """Tukey HSD por pares desde (n, media) por nivel y el MS del error.
+
+    Mismas columnas que la tabla de pairwise_tukeyhsd.
+    """
+    levels = sorted(level_stats)
+    k = len(levels)
+    rows = []
+    for i in range(k):
+        for j in range(i + 1, k):
+            n_i, mean_i = level_stats[levels[i]]
+            n_j, mean_j = level_stats[levels[j]]
+            diff = mean_j - mean_i
+            se = math.sqrt(ms_error / 2.0 * (1.0 / n_i + 1.0 / n_j))
+            q = abs(diff) / se if se > 0 else 0.0
+            p_adj = float(stats.studentized_range.sf(q, k, df_error))
+            q_crit = float(stats.studentized_range.ppf(1 - alpha, k, df_error))
+            margin = q_crit * se
+            rows.append({
+                "group1": levels[i],
+                "group2": levels[j],
+                "meandiff": round(diff, 4),
+                "p-adj": round(p_adj, 4),
+                "lower": round(diff - margin, 4),
+                "upper": round(diff + margin, 4),
+                "reject": p_adj < alpha,
+            })
+    return pd.DataFrame(rows)
+
+
+def anova_from_aggregates(
+    aggregates: CellAggregates,
+    factor1: str = "capacity",
+    factor2: str = "disruption",
+) -> AnovaResult:
+    """ANOVA de dos vías con interacción desde los agregados por celda.
+
+    Usa la descomposición clásica de sumas de cuadrados sobre los
+    estadísticos suficientes — exacta para diseños balanceados (mismo n
+    por celda), que es como corren las campañas del factorial; no
+    requiere statsmodels ni los datos crudos.
+    """
+    cells = aggregates.cells
+    if len(cells) < 2:
+        raise ValueError("Se necesitan al menos 2 celdas con datos para ANOVA")
+
+    levels1, levels2 = aggregates.levels()
+    a, b = len(levels1), len(levels2)
+
+    n_total = sum(c[0] for c in cells.values())
+    sum_total = sum(c[1] for c in cells.values())
+    sumsq_total = sum(c[2] for c in cells.values())
+    cf = sum_total * sum_total / n_total
+
+    ss_total = sumsq_total - cf
+    ss_cells = sum(c[1] ** 2 / c[0] for c in cells.values()) - cf
+
+    def _factor_ss(axis: int, levels: list[str]) -> tuple[float, dict[str, tuple[int, float]]]:
+        ss = 0.0
+        level_stats = {}
+        for level in levels:
+            n = sum(c[0] for key, c in cells.items() if key[axis] == level)
+            s = sum(c[1] for key, c in cells.items() if key[axis] == level)
+            ss += s * s / n
+            level_stats[level] = (n, s / n)
+        return ss - cf, level_stats
+
+    ss_1, stats_1 = _factor_ss(0, levels1)
+    ss_2, stats_2 = _factor_ss(1, levels2)
+    ss_inter = max(0.0, ss_cells - ss_1 - ss_2)
+    ss_error = max(0.0, ss_total - ss_cells)
+
+    df_1, df_2 = a - 1, b - 1
+    df_inter = df_1 * df_2
+    df_error = n_total - a * b
+    if df_error <= 0:
+        raise ValueError("Sin grados de libertad para el error (n <= celdas)")
+
+    ms_error = ss_error / df_error
+
+    def _row(ss: float, dof: int) -> dict:
+        ms = ss / dof if dof > 0 else 0.0
+        f = ms / ms_error if ms_error > 0 else np.inf
+        p = float(stats.f.sf(f, dof, df_error)) if np.isfinite(f) else 0.0
+        return {"sum_sq": ss, "df": dof, "mean_sq": ms, "F": f, "PR(>F)": p}
+
+    table = pd.DataFrame(
+        {
+            f"C({factor1})": _row(ss_1, df_1),
+            f"C({factor2})": _row(ss_2, df_2),
+            f"C({factor1}):C({factor2})": _row(ss_inter, df_inter),
+            "Residual": {
+                "sum_sq": ss_error, "df": df_error, "mean_sq": ms_error,
+                "F": np.nan, "PR(>F)": np.nan,
+            },
+        }
+    ).T
+
+    eta_squared = {
+        factor1: ss_1 / ss_total if ss_total > 0 else 0.0,
+        factor2: ss_2 / ss_total if ss_total > 0 else 0.0,
+        "interaction": ss_inter / ss_total if ss_total > 0 else 0.0,
+    }
+
+    main_effects = {
+        factor1: max(m for _, m in stats_1.values()) - min(m for _, m in stats_1.values()),
+        factor2: max(m for _, m in stats_2.values()) - min(m for _, m in stats_2.values()),
+    }
+
+    cell_means = np.array([c[1] / c[0] for c in cells.values()])
+    interaction_effect = float(np.std(cell_means, ddof=1)) if len(cell_means) > 1 else 0.0
+
+    r2 = 1.0 - ss_error / ss_total if ss_total > 0 else 0.0
+    model_df = a * b - 1
+    r2_adj = 1.0 - (1.0 - r2) * (n_total - 1) / (n_total - model_df - 1)
+
+    return AnovaResult(
+        table=table,
+        eta_squared=eta_squared,
+        main_effects=main_effects,
+        interaction_effect=interaction_effect,
+        r_squared=r2_adj,
+        tukey_capacity=_tukey_from_aggregates(stats_1, ms_error, df_error) if a > 1 else None,
+        tukey_disruption=_tukey_from_aggregates(stats_2, ms_error, df_error) if b > 1 else None,
+    )
+
+
 def anova_two_way(
     df: pd.DataFrame,
     response: str = "service_level_pct",
@@ -98,6 +291,57 @@ def confidence_intervals(
     return pd.DataFrame(results)
 
 
+def confidence_interval_from_stats(
+    n: int,
+    total: float,
+    sumsq: float,
+    alpha: float = 0.05
+) -> dict:
+    """Intervalo de confianza t desde estadísticos suficientes (n, suma, suma²).
+
+    Mismo cálculo que confidence_intervals, pero alimentado por agregados
+    SQL en lugar de las réplicas crudas, para que las vistas de comparación
+    no materialicen los valores individuales.
+    """
+    mean = total / n if n > 0 else 0.0
+    var = max(0.0, (sumsq - total * total / n) / (n - 1)) if n > 1 else 0.0
+    std = float(np.sqrt(var))
+    se = std / np.sqrt(n) if n > 0 else 0.0
+    margin = float(stats.t.ppf(1 - alpha / 2, n - 1) * se) if n > 1 else 0.0
+
+    return {
+        "n": int(n),
+        "mean": round(mean, 4),
+        "std": round(std, 4),
+        "se": round(se, 4),
+        "ci_lower": round(mean - margin, 4),
+        "ci_upper": round(mean + margin, 4),
+        "margin": round(margin, 4),
+    }
+
+
+def welch_test_from_stats(
+    n1: int, mean1: float, var1: float,
+    n2: int, mean2: float, var2: float,
+) -> tuple[float, float]:
+    """Test t de Welch desde (n, media, varianza) de dos grupos.
+
+    Retorna (estadístico t, p-valor bilateral). Con n <= 1 o varianzas
+    nulas en ambos grupos retorna (0.0, 1.0).
+    """
+    if n1 <= 1 or n2 <= 1:
+        return 0.0, 1.0
+    se_sq = var1 / n1 + var2 / n2
+    if se_sq <= 0:
+        return 0.0, 1.0
+    t_stat = (mean1 - mean2) / np.sqrt(se_sq)
+    df = se_sq ** 2 / (
+        (var1 / n1) ** 2 / (n1 - 1) + (var2 / n2) ** 2 / (n2 - 1)
+    )
+    p_value = float(2 * stats.t.sf(abs(t_stat), df))
+    return float(t_stat), p_value
+
+
 def descriptive_statistics(
     df: pd.DataFrame,
     group_col: str = "config_name",
@@ -0,0 +1,68 @@
+from __future__ import annotations
+
+import numpy as np
+
+from .config import SimulationConfig
+
+
+def replica_seed_sequence(
+    base_seed: int,
+    config_id: int,
+    replica: int,
+    crn: bool = False,
+) -> np.random.SeedSequence:
+    """SeedSequence hija independiente para el par (configuración, réplica).
+
+    La clave de spawn identifica a la hija de forma determinista, por lo que
+    los streams de dos réplicas cualesquiera no se solapan (a diferencia de
+    las semillas aritméticas base + offset). Con crn=True la clave omite la
+    configuración: la misma réplica comparte stream en todas las celdas
+    (números aleatorios comunes).
+    """
+    key = (replica,) if crn else (config_id, replica)
+    return np.random.SeedSequence(base_seed, spawn_key=key)
+
+
+def config_seed_sequence(config: SimulationConfig) -> np.random.SeedSequence:
+    """SeedSequence de una configuración resuelta (semilla + clave de spawn)."""
+    return np.random.SeedSequence(config.seed, spawn_key=config.spawn_key)
+
+
+def named_streams(
+    seed_seq: np.random.SeedSequence,
+) -> tuple[np.random.Generator, np.random.Generator, np.random.Generator]:
+    """Streams nominados (ruido de demanda, timing de disrupciones, duración
+    de disrupciones) derivados de una misma SeedSequence.
+
+    El orden de spawn es parte del contrato: todos los motores lo comparten
+    para que una misma semilla produzca la misma trayectoria.
+    """
+    demand_ss, timing_ss, duration_ss = seed_seq.spawn(3)
+    return (
+        np.random.default_rng(demand_ss),
+        np.random.default_rng(timing_ss),
+        np.random.default_rng(duration_ss),
+    )
+
+
+def sequence_key(seed_seq: np.random.SeedSequence) -> str:
+    """Clave 'entropía/k1.k2' de una SeedSequence."""
+    key = ".".join(str(k) for k in seed_seq.spawn_key)
+    return f"{seed_seq.entropy}/{key}" if key else str(seed_seq.entropy)
+
+
+def stream_key(config: SimulationConfig) -> str:
+    """Clave de stream registrada en las filas de resultados.
+
+    Reconstruye exactamente la SeedSequence de la réplica, de modo que
+    cualquier fila de una campaña es re-ejecutable sin conocer el esquema
+    de semillas con que se lanzó.
+    """
+    return sequence_key(config_seed_sequence(config))
+
+
+def parse_stream_key(key: str) -> tuple[int, tuple[int, ...]]:
+    """Inversa de stream_key: retorna (semilla, clave de spawn)."""
+    entropy, _, spawn = key.partition("/")
+    spawn_key = tuple(int(k) for k in spawn.split(".")) if spawn else ()
+    return int(entropy), spawn_key
@@ -0,0 +1,201 @@
+from __future__ import annotations
+from typing import Any
+
+import numpy as np
+
+from .config import SimulationConfig, SAFETY_MARGIN, MAX_CONCURRENT_ORDERS
+from .simulation import seasonal_demand_profile
+from .streams import config_seed_sequence, named_streams
+
+
+class VectorizedGLPSimulation:
+    """Motor alternativo sin SimPy: pre-genera los draws aleatorios como
+    arrays NumPy y avanza el balance de inventario con un loop diario sobre
+    buffers contiguos. Produce el mismo dict de KPIs que GLPSimulation.
+    """
+
+    def __init__(self, config: SimulationConfig):
+        self.config = config
+        # Mismos streams nominados que GLPSimulation (ver bll/streams.py)
+        self.demand_rng, self.disruption_timing_rng, self.disruption_duration_rng = \
+            named_streams(config_seed_sequence(config))
+        days = config.simulation_days
+
+        # Draws pre-generados
+        self._disruption_starts, self._disruption_durations = self._generate_disruptions()
+        self._demand_noise = self.demand_rng.normal(1.0, config.demand_variability, days)
+        if config.antithetic:
+            self._demand_noise = 2.0 - self._demand_noise
+        self._seasonal = seasonal_demand_profile(config)
+
+        # Buffers columnarios de métricas diarias
+        self.inventory_tm = np.zeros(days)
+        self.demand_tm = np.zeros(days)
+        self.satisfied_demand_tm = np.zeros(days)
+        self.supply_received_tm = np.zeros(days)
+        self.stockout = np.zeros(days, dtype=bool)
+        self.route_blocked = np.zeros(days, dtype=bool)
+        self.pending_orders = np.zeros(days, dtype=np.int64)
+        self.autonomy_days = np.zeros(days)
+
+        self.total_demand_tm = 0.0
+        self.satisfied_total_tm = 0.0
+        self.total_received_tm = 0.0
+        self.total_dispatched_tm = 0.0
+        self.final_inventory_tm = config.initial_inventory_tm
+        self.total_disruptions = len(self._disruption_starts)
+        self.total_blocked_days = float(np.sum(self._disruption_durations))
+
+    def _generate_disruptions(self) -> tuple[np.ndarray, np.ndarray]:
+        cfg = self.config
+        if cfg.disruption_max_days <= 0 or cfg.annual_disruption_rate <= 0:
+            return np.empty(0), np.empty(0)
+
+        lambda_days = cfg.annual_disruption_rate / 365.0
+
+        # Inter-arribos por lotes (misma secuencia que los draws de a uno);
+        # se acumulan batches hasta cruzar el horizonte
+        batch = max(8, int(2 * lambda_days * cfg.simulation_days) + 8)
+        times = np.empty(0)
+        t = 0.0
+        while True:
+            interarrivals = self.disruption_timing_rng.exponential(1.0 / lambda_days, batch)
+            chunk_times = t + np.cumsum(interarrivals)
+            times = np.concatenate([times, chunk_times])
+            if chunk_times[-1] >= cfg.simulation_days:
+                break
+            t = chunk_times[-1]
+
+        starts = times[times < cfg.simulation_days]
+        n = len(starts)
+        if cfg.disruption_min_days == cfg.disruption_mode_days == cfg.disruption_max_days:
+            durations = np.full(n, cfg.disruption_max_days)
+        else:
+            durations = self.disruption_duration_rng.triangular(
+                cfg.disruption_min_days,
+                cfg.disruption_mode_days,
+                cfg.disruption_max_days,
+                n,
+            )
+
+        return starts, durations
+
+    def run(self):
+        cfg = self.config
+        days = cfg.simulation_days
+        base = cfg.base_daily_demand_tm
+        capacity = cfg.capacity_tm
+
+        demand = np.maximum(0.0, base * self._seasonal * self._demand_noise)
+
+        inventory = cfg.initial_inventory_tm
+        unblock_time = 0.0
+        next_event = 0
+        # Órdenes en tránsito: (cantidad, día de llegada); FIFO por llegada
+        in_transit: list[tuple[float, float]] = []
+
+        for day in range(days):
+            # Disrupciones ocurridas hasta hoy (la última sobrescribe el desbloqueo)
+            while next_event < len(self._disruption_starts) and self._disruption_starts[next_event] <= day:
+                unblock_time = self._disruption_starts[next_event] + self._disruption_durations[next_event]
+                next_event += 1
+            blocked = day < unblock_time
+
+            # Llegadas de suministro vencidas (bloqueo FIFO por capacidad)
+            while in_transit and in_transit[0][1] <= day and inventory + in_transit[0][0] <= capacity:
+                quantity, _ = in_transit.pop(0)
+                inventory += quantity
+                self.total_received_tm += quantity
+                self.supply_received_tm[day] += quantity
+
+            # Demanda del día
+            d = demand[day]
+            dispatched = d if inventory >= d else inventory
+            inventory -= dispatched
+            self.total_demand_tm += d
+            self.satisfied_total_tm += dispatched
+            self.total_dispatched_tm += dispatched
+
+            # Reintento de llegadas que esperaban espacio
+            while in_transit and in_transit[0][1] <= day and inventory + in_transit[0][0] <= capacity:
+                quantity, _ = in_transit.pop(0)
+                inventory += quantity
+                self.total_received_tm += quantity
+                self.supply_received_tm[day] += quantity
+
+            self.inventory_tm[day] = inventory
+            self.demand_tm[day] = d
+            self.satisfied_demand_tm[day] = dispatched
+            self.stockout[day] = dispatched < d
+            self.route_blocked[day] = blocked
+            self.pending_orders[day] = len(in_transit)
+            self.autonomy_days[day] = inventory / d if d > 0 else 0.0
+
+            # Reposición (misma política que GLPSimulation._replenishment_process)
+            position = inventory + sum(q for q, _ in in_transit)
+            can_order = (
+                position <= cfg.reorder_point_tm and
+                len(in_transit) < MAX_CONCURRENT_ORDERS and
+                not blocked
+            )
+            if can_order:
+                lead_time = cfg.nominal_lead_time_days
+                q = base * lead_time * (1.0 + SAFETY_MARGIN)
+                q = max(0.0, min(q, capacity - inventory))
+                if q > 0:
+                    in_transit.append((q, day + lead_time))
+
+        self.final_inventory_tm = inventory
+
+    def calculate_kpis(self) -> dict[str, Any]:
+        if self.config.simulation_days == 0:
+            return {}
+
+        total_days = self.config.simulation_days
+        stockout_days = int(np.sum(self.stockout))
+
+        service_level = (self.satisfied_total_tm / self.total_demand_tm * 100.0) if self.total_demand_tm > 0 else 0.0
+        stockout_prob = (stockout_days / total_days * 100.0) if total_days > 0 else 0.0
+        blocked_pct = (self.total_blocked_days / self.config.simulation_days * 100.0)
+
+        return {
+            "service_level_pct": round(service_level, 4),
+            "stockout_probability_pct": round(stockout_prob, 4),
+            "stockout_days": stockout_days,
+            "avg_inventory_tm": round(float(np.mean(self.inventory_tm)), 2),
+            "min_inventory_tm": round(float(np.min(self.inventory_tm)), 2),
+            "max_inventory_tm": round(float(np.max(self.inventory_tm)), 2),
+            "std_inventory_tm": round(float(np.std(self.inventory_tm)), 2),
+            "final_inventory_tm": round(self.final_inventory_tm, 2),
+            "initial_inventory_tm": round(self.config.initial_inventory_tm, 2),
+            "avg_autonomy_days": round(float(np.mean(self.autonomy_days)), 2),
+            "min_autonomy_days": round(float(np.min(self.autonomy_days)), 2),
+            "total_demand_tm": round(self.total_demand_tm, 2),
+            "satisfied_demand_tm": round(self.satisfied_total_tm, 2),
+            "unsatisfied_demand_tm": round(self.total_demand_tm - self.satisfied_total_tm, 2),
+            "avg_daily_demand_tm": round(float(np.mean(self.demand_tm)), 2),
+            "max_daily_demand_tm": round(float(np.max(self.demand_tm)), 2),
+            "min_daily_demand_tm": round(float(np.min(self.demand_tm)), 2),
+            "total_received_tm": round(self.total_received_tm, 2),
+            "total_dispatched_tm": round(self.total_dispatched_tm, 2),
+            "total_disruptions": self.total_disruptions,
+            "total_blocked_days": round(self.total_blocked_days, 2),
+            "blocked_time_pct": round(blocked_pct, 2),
+            "simulated_days": total_days,
+        }
+
+    def build_time_series(self) -> list[dict[str, Any]]:
+        return [
+            {
+                "day": day,
+                "inventory": float(self.inventory_tm[day]),
+                "demand": float(self.demand_tm[day]),
+                "satisfied_demand": float(self.satisfied_demand_tm[day]),
+                "supply_received": float(self.supply_received_tm[day]),
+                "stockout": bool(self.stockout[day]),
+                "route_blocked": bool(self.route_blocked[day]),
+                "pending_orders": int(self.pending_orders[day]),
+                "autonomy_days": float(self.autonomy_days[day]),
+            }
+            for day in range(self.config.simulation_days)
+        ]
@@ -0,0 +1,47 @@
+from __future__ import annotations
+import atexit
+from concurrent.futures import ProcessPoolExecutor
+
+# Pool de workers persistente a nivel de proceso. Crear un
+# ProcessPoolExecutor por experimento paga spawn del intérprete más el
+# import de simpy/numpy/pandas antes de la primera réplica; este pool se
+# mantiene caliente entre experimentos y lo comparten la librería
+# (run_experiment) y los background tasks de FastAPI.
+
+_pool: ProcessPoolExecutor | None = None
+_pool_workers: int | None = None
+
+
+def _preload_worker():
+    """Pre-importa el stack de simulación al arrancar cada worker."""
+    import numpy  # noqa: F401
+    import pandas  # noqa: F401
+    import simpy  # noqa: F401
+    from bll import experiment, simulation, vectorized  # noqa: F401
+
+
+def get_worker_pool(max_workers: int | None = None) -> ProcessPoolExecutor:
+    """Retorna el pool compartido, creándolo (o redimensionándolo) si hace falta."""
+    global _pool, _pool_workers
+
+    if _pool is not None:
+        if max_workers is None or max_workers == _pool_workers:
+            return _pool
+        # Tamaño distinto solicitado explícitamente: reciclar el pool
+        _pool.shutdown(wait=True)
+        _pool = None
+
+    _pool = ProcessPoolExecutor(max_workers=max_workers, initializer=_preload_worker)
+    _pool_workers = max_workers
+    return _pool
+
+
+def shutdown_worker_pool(wait: bool = True):
+    global _pool, _pool_workers
+    if _pool is not None:
+        _pool.shutdown(wait=wait)
+        _pool = None
+        _pool_workers = None
+
+
+atexit.register(shutdown_worker_pool)
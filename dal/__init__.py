@@ -1,9 +1,15 @@
 """Data Access Layer - Persistence and Export."""
 from .checkpoint import CheckpointManager
-from .export import export_csv, export_json, generate_latex_table
+from .export import arrow_ipc_bytes, export_arrow, export_csv, export_json, generate_latex_table
+from .metrics_store import DailyMetricsStore
+from .result_cache import SimulationResultCache
 
 __all__ = [
     "CheckpointManager",
+    "DailyMetricsStore",
+    "SimulationResultCache",
+    "arrow_ipc_bytes",
+    "export_arrow",
     "export_csv",
     "export_json",
     "generate_latex_table",
@@ -3,8 +3,17 @@ import json
 from pathlib import Path
 from typing import Any
 
+import pandas as pd
+
 
 class CheckpointManager:
+    """Checkpoints de experimentos.
+
+    Formato v2: cada batch es un archivo Parquet con columnas tipadas
+    (el esquema de KPIs de calculate_kpis). Los checkpoints legacy v1
+    (batch_*.json) se siguen leyendo de forma transparente.
+    """
+
     def __init__(self, path: Path):
         self.path = Path(path)
         self.data_path = self.path / "checkpoint.json"
@@ -13,37 +22,57 @@ class CheckpointManager:
     def exists(self) -> bool:
         return self.data_path.exists()
 
+    def _batch_files(self) -> list[Path]:
+        if not self.results_path.exists():
+            return []
+        files = list(self.results_path.glob("batch_*.parquet"))
+        files += self.results_path.glob("batch_*.json")
+        return sorted(files)
+
+    def batch_count(self) -> int:
+        return len(self._batch_files())
+
     def load(self) -> tuple[int, list[dict]]:
+        config_id, df = self.load_dataframe()
+        if df.empty:
+            return config_id, []
+        return config_id, df.to_dict(orient="records")
+
+    def load_dataframe(self) -> tuple[int, pd.DataFrame]:
         if not self.exists():
-            return 0, []
+            return 0, pd.DataFrame()
 
         with open(self.data_path, "r") as f:
             data = json.load(f)
 
         config_id = data.get("last_config_id", 0)
-        results = []
+        frames = []
 
-        for batch_file in sorted(self.results_path.glob("batch_*.json")):
-            with open(batch_file, "r") as f:
-                batch = json.load(f)
-                results.extend(batch)
+        for batch_file in self._batch_files():
+            if batch_file.suffix == ".parquet":
+                frames.append(pd.read_parquet(batch_file))
+            else:
+                # Batch legacy v1 en JSON
+                with open(batch_file, "r") as f:
+                    frames.append(pd.DataFrame(json.load(f)))
 
-        return config_id, results
+        if not frames:
+            return config_id, pd.DataFrame()
+        return config_id, pd.concat(frames, ignore_index=True)
 
     def save(self, config_id: int, batch: list[dict], batch_num: int):
         self.path.mkdir(parents=True, exist_ok=True)
         self.results_path.mkdir(exist_ok=True)
 
         with open(self.data_path, "w") as f:
-            json.dump({"last_config_id": config_id}, f)
+            json.dump({"last_config_id": config_id, "format": 2}, f)
 
-        batch_file = self.results_path / f"batch_{batch_num:06d}.json"
-        with open(batch_file, "w") as f:
-            json.dump(batch, f)
+        batch_file = self.results_path / f"batch_{batch_num:06d}.parquet"
+        pd.DataFrame(batch).to_parquet(batch_file, index=False)
 
     def clear(self):
         if self.results_path.exists():
-            for f in self.results_path.glob("batch_*.json"):
+            for f in self._batch_files():
                 f.unlink()
             self.results_path.rmdir()
         if self.data_path.exists():
@@ -4,6 +4,22 @@ from pathlib import Path
 from typing import Any
 
 import pandas as pd
+import pyarrow as pa
+
+
+def arrow_ipc_bytes(df: pd.DataFrame) -> bytes:
+    """Serializa un DataFrame como Arrow IPC (columnas tipadas, sin JSON)."""
+    table = pa.Table.from_pandas(df, preserve_index=False)
+    sink = pa.BufferOutputStream()
+    with pa.ipc.new_file(sink, table.schema) as writer:
+        writer.write_table(table)
+    return sink.getvalue().to_pybytes()
+
+
+def export_arrow(df: pd.DataFrame, path: Path):
+    Path(path).parent.mkdir(parents=True, exist_ok=True)
+    with open(path, "wb") as f:
+        f.write(arrow_ipc_bytes(df))
 
 
 def export_csv(df: pd.DataFrame, path: Path, index: bool = False):
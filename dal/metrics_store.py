@@ -0,0 +1,397 @@
+from __future__ import annotations
+import json
+from pathlib import Path
+from typing import Any, Iterator
+
+import numpy as np
+
+# Un registro por día simulado; mismo esquema que los buffers columnarios
+# de los motores de simulación (ver bll/simulation.py)
+DAILY_DTYPE = np.dtype([
+    ("inventory", "f8"),
+    ("demand", "f8"),
+    ("satisfied_demand", "f8"),
+    ("supply_received", "f8"),
+    ("stockout", "?"),
+    ("route_blocked", "?"),
+    ("pending_orders", "i8"),
+    ("autonomy_days", "f8"),
+])
+
+DEFAULT_CHUNK_DAYS = 4096
+
+# Un registro por bucket de los rollups multi-resolución: envolventes
+# min/mean/max de los niveles, sumas de los flujos, conteos de los flags
+ROLLUP_DTYPE = np.dtype([
+    ("inventory_min", "f8"),
+    ("inventory_mean", "f8"),
+    ("inventory_max", "f8"),
+    ("demand", "f8"),
+    ("satisfied_demand", "f8"),
+    ("supply_received", "f8"),
+    ("stockout_days", "i8"),
+    ("route_blocked_days", "i8"),
+    ("pending_orders_max", "i8"),
+    ("autonomy_min", "f8"),
+    ("autonomy_mean", "f8"),
+    ("autonomy_max", "f8"),
+])
+
+# Resoluciones precomputadas al cerrar el store: semanal y mensual
+ROLLUP_BUCKETS = (7, 30)
+
+
+class DailyMetricsStore:
+    """Buffer de métricas diarias respaldado en disco, en chunks tipados.
+
+    Cada chunk es un archivo binario mapeado en memoria (np.memmap) con
+    DEFAULT_CHUNK_DAYS registros del dtype DAILY_DTYPE, de modo que la
+    memoria residente por réplica es O(chunk) y no O(horizonte): un
+    escenario de 20 años (7300 días) o más se escribe a disco a medida
+    que avanza la simulación. Los KPIs y las vistas ventaneadas o
+    agregadas se calculan chunk a chunk, sin materializar la serie
+    completa.
+    """
+
+    _META_FILE = "meta.json"
+
+    def __init__(self, path: Path, chunk_days: int = DEFAULT_CHUNK_DAYS):
+        self.path = Path(path)
+        self.chunk_days = chunk_days
+        self.total_days = 0
+        self._chunk: np.memmap | None = None
+        self._chunk_index = -1
+        self._rollups: list[int] = []
+
+    # -------------------------------------------------------------- escritura
+
+    def _chunk_file(self, index: int) -> Path:
+        return self.path / f"chunk_{index:06d}.bin"
+
+    def _open_next_chunk(self):
+        self.flush()
+        self.path.mkdir(parents=True, exist_ok=True)
+        self._chunk_index += 1
+        self._chunk = np.memmap(
+            self._chunk_file(self._chunk_index),
+            dtype=DAILY_DTYPE,
+            mode="w+",
+            shape=(self.chunk_days,),
+        )
+
+    def append(
+        self,
+        inventory: float,
+        demand: float,
+        satisfied_demand: float,
+        supply_received: float,
+        stockout: bool,
+        route_blocked: bool,
+        pending_orders: int,
+        autonomy_days: float,
+    ):
+        """Agrega las métricas de un día al chunk actual."""
+        offset = self.total_days % self.chunk_days
+        if offset == 0:
+            self._open_next_chunk()
+        row = self._chunk[offset]
+        row["inventory"] = inventory
+        row["demand"] = demand
+        row["satisfied_demand"] = satisfied_demand
+        row["supply_received"] = supply_received
+        row["stockout"] = stockout
+        row["route_blocked"] = route_blocked
+        row["pending_orders"] = pending_orders
+        row["autonomy_days"] = autonomy_days
+        self.total_days += 1
+
+    def append_block(
+        self,
+        inventory: np.ndarray,
+        demand: np.ndarray,
+        satisfied_demand: np.ndarray,
+        supply_received: np.ndarray,
+        stockout: np.ndarray,
+        route_blocked: np.ndarray,
+        pending_orders: np.ndarray,
+        autonomy_days: np.ndarray,
+    ):
+        """Vuelca columnas completas al store, chunk a chunk (motores que ya
+        tienen los buffers en memoria, ver bll/vectorized.py)."""
+        columns = {
+            "inventory": inventory,
+            "demand": demand,
+            "satisfied_demand": satisfied_demand,
+            "supply_received": supply_received,
+            "stockout": stockout,
+            "route_blocked": route_blocked,
+            "pending_orders": pending_orders,
+            "autonomy_days": autonomy_days,
+        }
+        n = len(inventory)
+        written = 0
+        while written < n:
+            offset = self.total_days % self.chunk_days
+            if offset == 0:
+                self._open_next_chunk()
+            take = min(self.chunk_days - offset, n - written)
+            for name, col in columns.items():
+                self._chunk[name][offset:offset + take] = col[written:written + take]
+            self.total_days += take
+            written += take
+
+    def add_supply_received(self, day: int, quantity_tm: float):
+        """Suma una llegada de suministro a un día ya registrado (las llegadas
+        se anotan retroactivamente sobre el último día, ver _supply_arrival)."""
+        chunk_index, offset = divmod(day, self.chunk_days)
+        if chunk_index == self._chunk_index and self._chunk is not None:
+            self._chunk["supply_received"][offset] += quantity_tm
+        else:
+            chunk = np.memmap(
+                self._chunk_file(chunk_index),
+                dtype=DAILY_DTYPE,
+                mode="r+",
+                shape=(self.chunk_days,),
+            )
+            chunk["supply_received"][offset] += quantity_tm
+            chunk.flush()
+
+    def flush(self):
+        if self._chunk is not None:
+            self._chunk.flush()
+
+    def close(self):
+        """Asegura los chunks en disco, precomputa los rollups
+        multi-resolución y escribe los metadatos. El store sigue siendo
+        legible después de cerrar."""
+        self.flush()
+        self._chunk = None
+        self.path.mkdir(parents=True, exist_ok=True)
+        for bucket_days in ROLLUP_BUCKETS:
+            if self.total_days >= bucket_days:
+                self._build_rollup(bucket_days)
+        with open(self.path / self._META_FILE, "w") as f:
+            json.dump({
+                "total_days": self.total_days,
+                "chunk_days": self.chunk_days,
+                "rollups": self._rollups,
+                "format": 2,
+            }, f)
+
+    # --------------------------------------------------------------- lectura
+
+    @classmethod
+    def exists(cls, path: Path) -> bool:
+        return (Path(path) / cls._META_FILE).exists()
+
+    @classmethod
+    def open(cls, path: Path) -> "DailyMetricsStore":
+        """Abre un store ya cerrado para lectura."""
+        with open(Path(path) / cls._META_FILE, "r") as f:
+            meta = json.load(f)
+        store = cls(path, chunk_days=meta["chunk_days"])
+        store.total_days = meta["total_days"]
+        store._chunk_index = max(0, -(-store.total_days // store.chunk_days)) - 1
+        store._rollups = meta.get("rollups", [])
+        return store
+
+    def _read_chunk(self, index: int) -> np.ndarray:
+        valid = min(self.chunk_days, self.total_days - index * self.chunk_days)
+        if index == self._chunk_index and self._chunk is not None:
+            return self._chunk[:valid]
+        chunk = np.memmap(
+            self._chunk_file(index),
+            dtype=DAILY_DTYPE,
+            mode="r",
+            shape=(self.chunk_days,),
+        )
+        return chunk[:valid]
+
+    def iter_chunks(self) -> Iterator[tuple[int, np.ndarray]]:
+        """Itera (día_inicial, registros) sobre los chunks, en orden."""
+        for index in range(self._chunk_index + 1):
+            yield index * self.chunk_days, self._read_chunk(index)
+
+    def window(self, start: int = 0, end: int | None = None) -> dict[str, np.ndarray]:
+        """Columnas de un rango de días [start, end), tocando solo los chunks
+        que lo intersectan."""
+        if end is None or end > self.total_days:
+            end = self.total_days
+        start = max(0, start)
+        if start >= end:
+            return {name: np.empty(0, dtype=DAILY_DTYPE[name]) for name in DAILY_DTYPE.names}
+
+        pieces = []
+        first = start // self.chunk_days
+        last = (end - 1) // self.chunk_days
+        for index in range(first, last + 1):
+            chunk = self._read_chunk(index)
+            base = index * self.chunk_days
+            lo = max(0, start - base)
+            hi = min(len(chunk), end - base)
+            pieces.append(chunk[lo:hi])
+
+        records = pieces[0] if len(pieces) == 1 else np.concatenate(pieces)
+        return {name: np.asarray(records[name]) for name in DAILY_DTYPE.names}
+
+    def downsample(self, bucket_days: int, start: int = 0, end: int | None = None) -> list[dict[str, Any]]:
+        """Serie agregada por buckets de bucket_days días (p. ej. 7 para la
+        vista semanal del dashboard): inventario y autonomía como promedio y
+        mínimo del bucket, flujos como suma, flags como ocurrencia."""
+        if end is None or end > self.total_days:
+            end = self.total_days
+        start = max(0, start)
+
+        records = []
+        for bucket_start in range(start, end, bucket_days):
+            w = self.window(bucket_start, min(bucket_start + bucket_days, end))
+            records.append({
+                "day": bucket_start,
+                "inventory": round(float(np.mean(w["inventory"])), 2),
+                "demand": round(float(np.sum(w["demand"])), 2),
+                "satisfied_demand": round(float(np.sum(w["satisfied_demand"])), 2),
+                "supply_received": round(float(np.sum(w["supply_received"])), 2),
+                "stockout": bool(np.any(w["stockout"])),
+                "route_blocked": bool(np.any(w["route_blocked"])),
+                "pending_orders": int(np.max(w["pending_orders"])),
+                "autonomy_days": round(float(np.min(w["autonomy_days"])), 2),
+            })
+        return records
+
+    # -------------------------------------------------------------- rollups
+
+    def _rollup_file(self, bucket_days: int) -> Path:
+        return self.path / f"rollup_{bucket_days:04d}.bin"
+
+    def _envelope_record(self, w: dict[str, np.ndarray]) -> tuple:
+        inv = w["inventory"]
+        aut = w["autonomy_days"]
+        return (
+            float(np.min(inv)), float(np.mean(inv)), float(np.max(inv)),
+            float(np.sum(w["demand"])),
+            float(np.sum(w["satisfied_demand"])),
+            float(np.sum(w["supply_received"])),
+            int(np.sum(w["stockout"])),
+            int(np.sum(w["route_blocked"])),
+            int(np.max(w["pending_orders"])),
+            float(np.min(aut)), float(np.mean(aut)), float(np.max(aut)),
+        )
+
+    def _build_rollup(self, bucket_days: int):
+        """Materializa el rollup de una resolución a un archivo tipado."""
+        num_buckets = -(-self.total_days // bucket_days)
+        rollup = np.empty(num_buckets, dtype=ROLLUP_DTYPE)
+        for i in range(num_buckets):
+            bucket_start = i * bucket_days
+            w = self.window(bucket_start, min(bucket_start + bucket_days, self.total_days))
+            rollup[i] = self._envelope_record(w)
+        rollup.tofile(self._rollup_file(bucket_days))
+        if bucket_days not in self._rollups:
+            self._rollups.append(bucket_days)
+
+    def resolution_for(self, width_px: int) -> int:
+        """Resolución más fina (1, 7 o 30 días por bucket) cuya serie cabe
+        en width_px puntos; para horizontes que exceden incluso la vista
+        mensual retorna la resolución mensual (el payload crece, pero
+        acotado por total_days / 30)."""
+        for bucket_days in (1, *ROLLUP_BUCKETS):
+            if -(-self.total_days // bucket_days) <= width_px:
+                return bucket_days
+        return ROLLUP_BUCKETS[-1]
+
+    def envelope(self, bucket_days: int, start: int = 0, end: int | None = None) -> list[dict[str, Any]]:
+        """Serie envolvente (min/mean/max por bucket) de un rango de días,
+        leída del rollup precomputado cuando la resolución existe en disco
+        y calculada sobre la marcha en caso contrario."""
+        if end is None or end > self.total_days:
+            end = self.total_days
+        start = max(0, start)
+        if start >= end:
+            return []
+
+        first = start // bucket_days
+        last = -(-end // bucket_days)
+
+        if bucket_days in self._rollups:
+            num_buckets = -(-self.total_days // bucket_days)
+            rollup = np.memmap(
+                self._rollup_file(bucket_days),
+                dtype=ROLLUP_DTYPE,
+                mode="r",
+                shape=(num_buckets,),
+            )
+            records = rollup[first:last]
+        else:
+            records = np.empty(last - first, dtype=ROLLUP_DTYPE)
+            for i in range(first, last):
+                bucket_start = i * bucket_days
+                w = self.window(bucket_start, min(bucket_start + bucket_days, self.total_days))
+                records[i - first] = self._envelope_record(w)
+
+        return [
+            {
+                "day": (first + i) * bucket_days,
+                "bucket_days": bucket_days,
+                "inventory_min": round(float(r["inventory_min"]), 2),
+                "inventory_mean": round(float(r["inventory_mean"]), 2),
+                "inventory_max": round(float(r["inventory_max"]), 2),
+                "demand": round(float(r["demand"]), 2),
+                "satisfied_demand": round(float(r["satisfied_demand"]), 2),
+                "supply_received": round(float(r["supply_received"]), 2),
+                "stockout_days": int(r["stockout_days"]),
+                "route_blocked_days": int(r["route_blocked_days"]),
+                "pending_orders_max": int(r["pending_orders_max"]),
+                "autonomy_min": round(float(r["autonomy_min"]), 2),
+                "autonomy_mean": round(float(r["autonomy_mean"]), 2),
+                "autonomy_max": round(float(r["autonomy_max"]), 2),
+            }
+            for i, r in enumerate(records)
+        ]
+
+    def aggregates(self) -> dict[str, Any]:
+        """Estadísticos por columna acumulados chunk a chunk, para calcular
+        KPIs sin materializar la serie completa."""
+        n = 0
+        inv_sum = inv_sumsq = 0.0
+        inv_min = np.inf
+        inv_max = -np.inf
+        aut_sum = 0.0
+        aut_min = np.inf
+        dem_sum = 0.0
+        dem_min = np.inf
+        dem_max = -np.inf
+        stockout_days = 0
+
+        for _, chunk in self.iter_chunks():
+            inv = chunk["inventory"]
+            aut = chunk["autonomy_days"]
+            dem = chunk["demand"]
+            n += len(chunk)
+            inv_sum += float(np.sum(inv))
+            inv_sumsq += float(np.sum(inv * inv))
+            inv_min = min(inv_min, float(np.min(inv)))
+            inv_max = max(inv_max, float(np.max(inv)))
+            aut_sum += float(np.sum(aut))
+            aut_min = min(aut_min, float(np.min(aut)))
+            dem_sum += float(np.sum(dem))
+            dem_min = min(dem_min, float(np.min(dem)))
+            dem_max = max(dem_max, float(np.max(dem)))
+            stockout_days += int(np.sum(chunk["stockout"]))
+
+        if n == 0:
+            return {"days": 0}
+
+        inv_mean = inv_sum / n
+        inv_var = max(0.0, inv_sumsq / n - inv_mean * inv_mean)
+        return {
+            "days": n,
+            "inventory": {
+                "mean": inv_mean,
+                "min": inv_min,
+                "max": inv_max,
+                "std": float(np.sqrt(inv_var)),
+            },
+            "autonomy_days": {"mean": aut_sum / n, "min": aut_min},
+            "demand": {"mean": dem_sum / n, "min": dem_min, "max": dem_max},
+            "stockout_days": stockout_days,
+        }
@@ -0,0 +1,35 @@
+from __future__ import annotations
+import json
+from pathlib import Path
+
+
+class SimulationResultCache:
+    """Cache de KPIs direccionado por contenido.
+
+    La clave es SimulationConfig.config_hash(); cada entrada es un archivo
+    JSON con el dict de KPIs. Permite que campañas idénticas (misma celda y
+    misma semilla) no se re-simulen.
+    """
+
+    def __init__(self, path: Path):
+        self.path = Path(path)
+
+    def _entry(self, key: str) -> Path:
+        return self.path / f"{key}.json"
+
+    def get(self, key: str) -> dict | None:
+        entry = self._entry(key)
+        if not entry.exists():
+            return None
+        with open(entry, "r") as f:
+            return json.load(f)
+
+    def put(self, key: str, kpis: dict):
+        self.path.mkdir(parents=True, exist_ok=True)
+        with open(self._entry(key), "w") as f:
+            json.dump(kpis, f)
+
+    def clear(self):
+        if self.path.exists():
+            for f in self.path.glob("*.json"):
+                f.unlink()